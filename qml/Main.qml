@@ -15,11 +15,14 @@ ApplicationWindow {
     Settings {
         id: settings
         property bool darkMode: true
+        // Read back by AppController before it opens the first ledger.
+        property string ledger: ""
     }
 
     Material.theme: settings.darkMode ? Material.Dark : Material.Light
 
     property string monthLabel: Qt.formatDate(appController.currentMonth, "MMMM yyyy")
+    property var activeFilters: ({ typeFilter: -1, categoryFilter: "", textFilter: "" })
 
     header: ToolBar {
         RowLayout {
@@ -47,6 +50,41 @@ ApplicationWindow {
 
             Item { Layout.fillWidth: true }
 
+            ComboBox {
+                id: ledgerBox
+                Layout.preferredWidth: 180
+                model: appController.ledgers
+                currentIndex: appController.ledgers.indexOf(appController.currentLedger)
+                onActivated: function(index) {
+                    if (appController.switchLedger(textAt(index))) {
+                        settings.ledger = appController.currentLedger
+                    }
+                }
+            }
+
+            ToolButton {
+                text: qsTr("All Ledgers")
+                enabled: appController.ledgers.length > 1
+                onClicked: ledgerSummaryDialog.openForMonth()
+            }
+
+            ToolButton {
+                text: qsTr("New Ledger")
+                onClicked: ledgerDialog.openForCreate()
+            }
+
+            ToolButton {
+                text: qsTr("Review (%1)").arg(appController.anomalyDetector.findingsModel.count)
+                enabled: appController.anomalyDetector.findingsModel.count > 0
+                         || appController.anomalyDetector.lastError.length > 0
+                onClicked: findingsDialog.open()
+            }
+
+            ToolButton {
+                text: qsTr("Export")
+                onClicked: exportDialog.openForExport()
+            }
+
             RowLayout {
                 spacing: 6
 
@@ -77,12 +115,84 @@ ApplicationWindow {
         }
     }
 
+    Dialog {
+        id: ledgerDialog
+        modal: true
+        x: (parent.width - width) / 2
+        y: (parent.height - height) / 2
+        width: 360
+        title: qsTr("New Ledger")
+        standardButtons: Dialog.Cancel | Dialog.Ok
+
+        property bool failed: false
+
+        function openForCreate() {
+            failed = false
+            ledgerNameField.text = ""
+            open()
+            ledgerNameField.forceActiveFocus()
+        }
+
+        onAccepted: {
+            if (appController.createLedger(ledgerNameField.text)) {
+                settings.ledger = appController.currentLedger
+            } else {
+                failed = true
+                open()
+            }
+        }
+
+        contentItem: ColumnLayout {
+            spacing: 8
+
+            TextField {
+                id: ledgerNameField
+                Layout.fillWidth: true
+                placeholderText: qsTr("Ledger name")
+            }
+
+            Label {
+                Layout.fillWidth: true
+                visible: ledgerDialog.failed
+                wrapMode: Text.WordWrap
+                color: Material.accent
+                text: qsTr("Couldn't create the ledger. Use letters, digits, spaces or dashes, and a name that isn't taken.")
+            }
+        }
+    }
+
+    LedgerSummaryDialog {
+        id: ledgerSummaryDialog
+        controller: appController
+        monthLabel: window.monthLabel
+    }
+
+    ExportDialog {
+        id: exportDialog
+        exporter: appController.reportExporter
+        month: appController.currentMonth
+        filters: window.activeFilters
+    }
+
+    TransactionRowColors {
+        id: rowColors
+        incomeColor: window.Material.accent
+        expenseColor: window.Material.primary
+        textColor: window.Material.foreground
+        hintColor: window.Material.hintTextColor
+        borderColor: window.Material.frameColor
+    }
+
+    FindingsDialog {
+        id: findingsDialog
+        detector: appController.anomalyDetector
+    }
+
     Snackbar {
         id: snackbar
         anchors.horizontalCenter: parent.horizontalCenter
         anchors.bottom: parent.bottom
         anchors.bottomMargin: 24
-        onActionTriggered: appController.undoDelete()
     }
 
     Dialog {
@@ -135,6 +245,7 @@ ApplicationWindow {
             Layout.fillWidth: true
             categories: appController.categories
             onFiltersChanged: function(payload) {
+                window.activeFilters = payload
                 appController.setFilters(payload.typeFilter, payload.categoryFilter, payload.textFilter)
             }
         }
@@ -150,8 +261,19 @@ ApplicationWindow {
                 clip: true
                 model: appController.transactionsModel
                 spacing: 8
-                delegate: TransactionDelegate {
+                // Rows scrolled out are parked and rebound instead of destroyed,
+                // and one extra viewport is kept built on each side for flicks.
+                reuseItems: true
+                cacheBuffer: Math.max(0, height)
+                delegate: TransactionRow {
                     width: ListView.view.width
+                    height: implicitHeight
+                    row: model.row
+                    colors: rowColors
+                    Accessible.role: Accessible.Button
+                    Accessible.name: accessibleName
+                    Accessible.description: qsTr("Press Enter to edit or Delete to remove")
+                    Accessible.onPressAction: transactionDialog.openForEdit(model)
                     onEditRequested: transactionDialog.openForEdit(model)
                     onDeleteRequested: appController.deleteTransaction(model.id)
                 }
@@ -181,7 +303,25 @@ ApplicationWindow {
     Connections {
         target: appController
         function onTransactionDeleted() {
-            snackbar.show(qsTr("Deleted"), qsTr("Undo"))
+            snackbar.show(qsTr("Deleted"), qsTr("Undo"), function() { appController.undoDelete() })
+        }
+        function onDuplicateDetected(ledger, transactionId, relatedId) {
+            snackbar.show(qsTr("This looks like a duplicate of transaction #%1").arg(relatedId), qsTr("Remove"),
+                          function() { appController.removeDuplicate(ledger, transactionId) })
+        }
+        // Snackbar actions refer to rows in the ledger being left.
+        function onCurrentLedgerChanged() {
+            snackbar.hide()
+        }
+    }
+
+    Connections {
+        target: appController.reportExporter
+        function onExportFinished(ok, filePath, rowCount) {
+            if (ok) {
+                exportDialog.close()
+                snackbar.show(qsTr("Exported %1 transactions").arg(rowCount), "")
+            }
         }
     }
 }
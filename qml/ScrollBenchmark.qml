@@ -0,0 +1,73 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+
+import ExpenseTracker 1.0
+
+ApplicationWindow {
+    id: window
+    width: 1024
+    height: 720
+    visible: true
+    title: qsTr("Scroll Benchmark")
+
+    TransactionRowColors {
+        id: rowColors
+        incomeColor: window.Material.accent
+        expenseColor: window.Material.primary
+        textColor: window.Material.foreground
+        hintColor: window.Material.hintTextColor
+        borderColor: window.Material.frameColor
+    }
+
+    ListView {
+        id: list
+        anchors.fill: parent
+        anchors.margins: 20
+        clip: true
+        interactive: false
+        model: benchModel
+        spacing: 8
+        reuseItems: true
+        cacheBuffer: Math.max(0, height)
+        delegate: benchNativeDelegate ? nativeRow : qmlRow
+    }
+
+    Component {
+        id: nativeRow
+
+        TransactionRow {
+            width: ListView.view.width
+            height: implicitHeight
+            row: model.row
+            colors: rowColors
+        }
+    }
+
+    Component {
+        id: qmlRow
+
+        TransactionDelegate {
+            width: ListView.view.width
+        }
+    }
+
+    NumberAnimation {
+        id: scroll
+        target: list
+        property: "contentY"
+        from: list.originY
+        to: list.originY + benchDistance
+        duration: benchDuration
+        onFinished: benchmark.finish()
+    }
+
+    // Give the first frames time to settle before measuring.
+    Timer {
+        interval: 500
+        running: true
+        onTriggered: {
+            benchmark.start()
+            scroll.start()
+        }
+    }
+}
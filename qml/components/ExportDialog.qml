@@ -0,0 +1,119 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Dialogs
+import QtQuick.Layouts 1.15
+
+Dialog {
+    id: root
+    modal: true
+    x: (parent.width - width) / 2
+    y: (parent.height - height) / 2
+    width: 420
+    title: qsTr("Export Transactions")
+    closePolicy: exporter && exporter.running ? Popup.NoAutoClose : Popup.CloseOnEscape
+
+    property var exporter: null
+    property date month: new Date()
+    property var filters: ({ typeFilter: -1, categoryFilter: "", textFilter: "" })
+
+    readonly property var extensions: ["csv", "json", "html", "pdf"]
+
+    function openForExport() {
+        exporter.clearError()
+        open()
+    }
+
+    function rangeStart() {
+        if (rangeBox.currentIndex === 0) {
+            return new Date(month.getFullYear(), month.getMonth(), 1)
+        }
+        if (rangeBox.currentIndex === 1) {
+            return new Date(month.getFullYear(), 0, 1)
+        }
+        return new Date(NaN)
+    }
+
+    function rangeEnd() {
+        if (rangeBox.currentIndex === 0) {
+            return new Date(month.getFullYear(), month.getMonth() + 1, 0)
+        }
+        if (rangeBox.currentIndex === 1) {
+            return new Date(month.getFullYear(), 11, 31)
+        }
+        return new Date(NaN)
+    }
+
+    function startExport(fileUrl) {
+        exporter.exportReport(formatBox.currentIndex, fileUrl, rangeStart(), rangeEnd(),
+                              filters.typeFilter, filters.categoryFilter, filters.textFilter)
+    }
+
+    FileDialog {
+        id: fileDialog
+        fileMode: FileDialog.SaveFile
+        defaultSuffix: root.extensions[formatBox.currentIndex]
+        nameFilters: [formatBox.currentText + " (*." + root.extensions[formatBox.currentIndex] + ")"]
+        onAccepted: root.startExport(selectedFile.toString())
+    }
+
+    contentItem: ColumnLayout {
+        spacing: 12
+
+        ComboBox {
+            id: formatBox
+            Layout.fillWidth: true
+            enabled: !root.exporter.running
+            model: [qsTr("CSV"), qsTr("JSON"), qsTr("HTML"), qsTr("PDF")]
+        }
+
+        ComboBox {
+            id: rangeBox
+            Layout.fillWidth: true
+            enabled: !root.exporter.running
+            model: [qsTr("This month"), qsTr("This year"), qsTr("All time")]
+        }
+
+        Label {
+            Layout.fillWidth: true
+            wrapMode: Text.WordWrap
+            color: Material.hintTextColor
+            text: qsTr("Uses the current type, category and search filters.")
+        }
+
+        ProgressBar {
+            Layout.fillWidth: true
+            visible: root.exporter.running
+            value: root.exporter.progress
+        }
+
+        Label {
+            Layout.fillWidth: true
+            visible: root.exporter.lastError.length > 0
+            wrapMode: Text.WordWrap
+            color: Material.accent
+            text: root.exporter.lastError
+        }
+    }
+
+    footer: DialogButtonBox {
+        // ActionRole keeps the dialog open, so progress stays visible until the
+        // worker has actually stopped.
+        Button {
+            text: qsTr("Cancel Export")
+            visible: root.exporter.running
+            DialogButtonBox.buttonRole: DialogButtonBox.ActionRole
+            onClicked: root.exporter.cancel()
+        }
+        Button {
+            text: qsTr("Close")
+            enabled: !root.exporter.running
+            DialogButtonBox.buttonRole: DialogButtonBox.RejectRole
+        }
+        Button {
+            text: qsTr("Export")
+            enabled: !root.exporter.running
+            DialogButtonBox.buttonRole: DialogButtonBox.ApplyRole
+        }
+        onApplied: fileDialog.open()
+    }
+}
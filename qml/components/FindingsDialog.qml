@@ -0,0 +1,107 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.15
+
+Dialog {
+    id: root
+    modal: true
+    x: (parent.width - width) / 2
+    y: (parent.height - height) / 2
+    width: 520
+    height: 480
+    title: qsTr("Possible Duplicates and Outliers")
+    standardButtons: Dialog.Close
+
+    property var detector: null
+
+    function kindLabel(kind) {
+        if (kind === 0) {
+            return qsTr("Duplicate")
+        }
+        if (kind === 1) {
+            return qsTr("Near duplicate")
+        }
+        return qsTr("Outlier")
+    }
+
+    contentItem: ColumnLayout {
+        spacing: 8
+
+        Label {
+            Layout.fillWidth: true
+            visible: root.detector.scanning
+            color: Material.hintTextColor
+            text: qsTr("Scanning ledger…")
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            visible: root.detector.lastError.length > 0
+            spacing: 8
+
+            Label {
+                Layout.fillWidth: true
+                wrapMode: Text.WordWrap
+                color: Material.accent
+                text: qsTr("Scan failed: %1").arg(root.detector.lastError)
+            }
+
+            Button {
+                text: qsTr("Retry")
+                onClicked: root.detector.rescan()
+            }
+        }
+
+        ListView {
+            id: findingsList
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            spacing: 4
+            model: root.detector.findingsModel
+
+            delegate: Pane {
+                width: ListView.view.width
+
+                contentItem: ColumnLayout {
+                    spacing: 2
+
+                    RowLayout {
+                        Layout.fillWidth: true
+                        spacing: 8
+
+                        Label {
+                            text: root.kindLabel(model.kind)
+                            font.weight: Font.DemiBold
+                        }
+
+                        Label {
+                            Layout.fillWidth: true
+                            text: model.date + "  " + model.category
+                            elide: Text.ElideRight
+                        }
+
+                        Label {
+                            text: model.amountFormatted
+                        }
+                    }
+
+                    Label {
+                        Layout.fillWidth: true
+                        text: model.description
+                        color: Material.hintTextColor
+                        font.pixelSize: 12
+                        elide: Text.ElideRight
+                    }
+                }
+            }
+
+            Label {
+                anchors.centerIn: parent
+                visible: findingsList.count === 0 && !root.detector.scanning
+                         && root.detector.lastError.length === 0
+                text: qsTr("Nothing suspicious found")
+            }
+        }
+    }
+}
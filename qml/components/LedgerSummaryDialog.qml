@@ -0,0 +1,77 @@
+import QtQuick 2.15
+import QtQuick.Controls 2.15
+import QtQuick.Layouts 1.15
+
+Dialog {
+    id: root
+    modal: true
+    x: (parent.width - width) / 2
+    y: (parent.height - height) / 2
+    width: 420
+    title: qsTr("All Ledgers — %1").arg(monthLabel)
+    standardButtons: Dialog.Close
+
+    property var controller: null
+    property string monthLabel: ""
+    property bool loading: false
+    property var summary: ({})
+
+    function openForMonth() {
+        loading = true
+        summary = {}
+        open()
+        controller.requestCrossLedgerSummary([])
+    }
+
+    Connections {
+        target: root.controller
+        function onCrossLedgerSummaryReady(result) {
+            root.summary = result
+            root.loading = false
+        }
+    }
+
+    contentItem: ColumnLayout {
+        spacing: 12
+
+        BusyIndicator {
+            Layout.alignment: Qt.AlignHCenter
+            visible: root.loading
+            running: root.loading
+        }
+
+        Label {
+            Layout.fillWidth: true
+            visible: !root.loading && root.summary.error !== undefined
+            wrapMode: Text.WordWrap
+            color: Material.accent
+            text: qsTr("Couldn't summarize ledgers: %1").arg(root.summary.error || "")
+        }
+
+        GridLayout {
+            Layout.fillWidth: true
+            visible: !root.loading && root.summary.error === undefined
+            columns: 2
+            columnSpacing: 24
+            rowSpacing: 8
+
+            Label { text: qsTr("Ledgers") }
+            Label { text: root.summary.ledgerCount || 0 }
+
+            Label { text: qsTr("Income") }
+            Label { text: root.summary.incomeFormatted || "" }
+
+            Label { text: qsTr("Expenses") }
+            Label { text: root.summary.expensesFormatted || "" }
+
+            Label {
+                text: qsTr("Net")
+                font.weight: Font.DemiBold
+            }
+            Label {
+                text: root.summary.netFormatted || ""
+                font.weight: Font.DemiBold
+            }
+        }
+    }
+}
@@ -12,22 +12,32 @@ Item {
 
     property string message: ""
     property string actionText: ""
+    property var actionHandler: null
 
     Timer {
         id: hideTimer
         interval: 5000
         running: false
         repeat: false
-        onTriggered: root.visible = false
+        onTriggered: root.hide()
     }
 
-    function show(messageText, actionLabel) {
+    // `handler` runs when the action is clicked; without one the action
+    // only emits actionTriggered.
+    function show(messageText, actionLabel, handler) {
         root.message = messageText
         root.actionText = actionLabel
+        root.actionHandler = handler === undefined ? null : handler
         root.visible = true
         hideTimer.restart()
     }
 
+    function hide() {
+        hideTimer.stop()
+        root.visible = false
+        root.actionHandler = null
+    }
+
     Rectangle {
         id: content
         anchors.fill: parent
@@ -50,7 +60,11 @@ Item {
                 text: root.actionText
                 visible: root.actionText.length > 0
                 onClicked: {
+                    const handler = root.actionHandler
                     root.visible = false
+                    if (handler) {
+                        handler()
+                    }
                     root.actionTriggered()
                 }
             }
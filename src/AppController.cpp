@@ -1,25 +1,51 @@
 #include "AppController.h"
 
 #include "db/Database.h"
+#include "db/LedgerManager.h"
 
 #include <QLocale>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QDateTime>
 #include <QDebug>
+#include <QFileInfo>
+#include <QSettings>
 
 AppController::AppController(QObject *parent)
     : QObject(parent)
 {
     QString errorMessage;
-    m_db = Database::open(errorMessage);
+    m_currentLedger = LedgerManager::defaultLedgerName();
+
+    // The saved ledger is opened directly so startup never loads Default
+    // first. One that was deleted or fails to open falls back to Default.
+    QSettings settings;
+    const QString savedLedger = settings.value("ledger").toString();
+    if (!savedLedger.isEmpty() && savedLedger != m_currentLedger) {
+        QString ledgerError;
+        const QString path = LedgerManager::ledgerPath(savedLedger, ledgerError);
+        if (!path.isEmpty() && QFileInfo::exists(path)) {
+            m_db = Database::open(path, ledgerError);
+        }
+        if (m_db.isOpen()) {
+            m_currentLedger = savedLedger;
+        } else {
+            qWarning() << "Saved ledger unavailable:" << savedLedger << ledgerError;
+            settings.remove("ledger");
+        }
+    }
+
+    if (!m_db.isOpen()) {
+        m_db = Database::open(errorMessage);
+    }
     if (!m_db.isOpen()) {
         qWarning() << "Database open failed:" << errorMessage;
-        m_dbErrorMessage = errorMessage;
-        emit dbErrorMessageChanged();
+        setDbErrorMessage(errorMessage);
     }
 
     m_model.setDatabase(m_db);
+    m_reportExporter.setDatabasePath(m_db.databaseName());
+    m_anomalyDetector.setDatabasePath(m_db.databaseName());
 
     m_currentMonth = QDate::currentDate();
     m_currentMonth = QDate(m_currentMonth.year(), m_currentMonth.month(), 1);
@@ -27,10 +53,21 @@ AppController::AppController(QObject *parent)
     m_model.setMonth(m_currentMonth);
     refreshSummary();
     refreshCategories();
+    refreshLedgers();
 
     m_undoTimer.setInterval(5000);
     m_undoTimer.setSingleShot(true);
     connect(&m_undoTimer, &QTimer::timeout, this, &AppController::clearUndo);
+    // Tagged with the ledger so a later Remove cannot hit another ledger's row.
+    connect(&m_anomalyDetector, &AnomalyDetector::duplicateDetected, this,
+            [this](int transactionId, int relatedId) {
+                emit duplicateDetected(m_currentLedger, transactionId, relatedId);
+            });
+}
+
+AppController::~AppController()
+{
+    m_summaryPool.waitForDone();
 }
 
 QDate AppController::currentMonth() const
@@ -78,6 +115,16 @@ TransactionsModel *AppController::transactionsModel()
     return &m_model;
 }
 
+ReportExporter *AppController::reportExporter()
+{
+    return &m_reportExporter;
+}
+
+AnomalyDetector *AppController::anomalyDetector()
+{
+    return &m_anomalyDetector;
+}
+
 bool AppController::undoAvailable() const
 {
     return m_undoAvailable;
@@ -88,6 +135,16 @@ QString AppController::dbErrorMessage() const
     return m_dbErrorMessage;
 }
 
+QStringList AppController::ledgers() const
+{
+    return m_ledgers;
+}
+
+QString AppController::currentLedger() const
+{
+    return m_currentLedger;
+}
+
 void AppController::nextMonth()
 {
     setMonth(m_currentMonth.addMonths(1));
@@ -107,7 +164,7 @@ void AppController::setMonth(const QDate &month)
     m_currentMonth = normalized;
     emit currentMonthChanged();
     m_model.setMonth(m_currentMonth);
-    refreshSummary();
+    refreshSummary(true);
 }
 
 bool AppController::addTransaction(int type, int amountCents, const QDate &date,
@@ -133,6 +190,8 @@ bool AppController::addTransaction(int type, int amountCents, const QDate &date,
         m_model.reload();
         refreshSummary();
         refreshCategories();
+        m_anomalyDetector.checkTransaction(query.lastInsertId().toInt(), type, amountCents, date, category,
+                                           note);
     }
 
     return ok;
@@ -161,6 +220,7 @@ bool AppController::updateTransaction(int id, int type, int amountCents, const Q
         m_model.reload();
         refreshSummary();
         refreshCategories();
+        m_anomalyDetector.updateTransaction(id, type, amountCents, date, category, note);
     }
 
     return ok;
@@ -197,6 +257,7 @@ bool AppController::deleteTransaction(int id)
         m_model.reload();
         refreshSummary();
         refreshCategories();
+        m_anomalyDetector.removeTransaction(id);
 
         m_undoAvailable = true;
         emit undoAvailableChanged();
@@ -227,6 +288,9 @@ bool AppController::undoDelete()
 
     const bool ok = query.exec();
     if (ok) {
+        // Restored rows are not new, so they do not raise a duplicate prompt.
+        m_anomalyDetector.updateTransaction(m_lastDeleted.id, m_lastDeleted.type, m_lastDeleted.amountCents,
+                                            m_lastDeleted.date, m_lastDeleted.category, m_lastDeleted.note);
         clearUndo();
         m_model.reload();
         refreshSummary();
@@ -236,12 +300,107 @@ bool AppController::undoDelete()
     return ok;
 }
 
+bool AppController::removeDuplicate(const QString &ledger, int transactionId)
+{
+    if (ledger != m_currentLedger) {
+        qWarning() << "Duplicate belongs to another ledger:" << ledger;
+        return false;
+    }
+    return deleteTransaction(transactionId);
+}
+
 void AppController::setFilters(int typeFilter, const QString &categoryFilter, const QString &textFilter)
 {
     m_model.setFilters(typeFilter, categoryFilter, textFilter);
 }
 
-void AppController::refreshSummary()
+bool AppController::switchLedger(const QString &name)
+{
+    if (name == m_currentLedger && m_db.isOpen()) {
+        return true;
+    }
+
+    QString errorMessage;
+    const QString path = LedgerManager::ledgerPath(name, errorMessage);
+    // Opening a missing file would let SQLite recreate it as an empty ledger.
+    if (!path.isEmpty() && name != LedgerManager::defaultLedgerName() && !QFileInfo::exists(path)) {
+        qWarning() << "Ledger no longer exists:" << name;
+        refreshLedgers();
+        return false;
+    }
+    const QSqlDatabase db = path.isEmpty() ? QSqlDatabase() : Database::open(path, errorMessage);
+    if (!db.isOpen()) {
+        qWarning() << "Ledger open failed:" << name << errorMessage;
+        setDbErrorMessage(errorMessage);
+        return false;
+    }
+
+    // The pending undo belongs to the ledger we are leaving.
+    clearUndo();
+
+    m_db = db;
+    m_currentLedger = name;
+    emit currentLedgerChanged();
+    setDbErrorMessage(QString());
+
+    m_model.setDatabase(m_db);
+    m_model.reload();
+    m_reportExporter.setDatabasePath(m_db.databaseName());
+    m_anomalyDetector.setDatabasePath(m_db.databaseName());
+    refreshSummary(true);
+    refreshCategories(true);
+
+    return true;
+}
+
+bool AppController::createLedger(const QString &name)
+{
+    const QString trimmed = name.trimmed();
+    QString errorMessage;
+    if (!LedgerManager::createLedger(trimmed, errorMessage)) {
+        qWarning() << "Ledger create failed:" << trimmed << errorMessage;
+        return false;
+    }
+
+    refreshLedgers();
+    return switchLedger(trimmed);
+}
+
+void AppController::requestCrossLedgerSummary(const QStringList &ledgers)
+{
+    const QDate firstDay(m_currentMonth.year(), m_currentMonth.month(), 1);
+    const QDate lastDay = firstDay.addMonths(1).addDays(-1);
+    const QStringList names = ledgers.isEmpty() ? m_ledgers : ledgers;
+
+    // Runs on a private pool so summarize() can block on its own batches
+    // without tying up the GUI thread or the global pool.
+    m_summaryPool.start([this, names, firstDay, lastDay]() {
+        LedgerManager::Summary summary;
+        QString errorMessage;
+        const bool ok = LedgerManager::summarize(names, firstDay, lastDay, summary, errorMessage);
+
+        QVariantMap result;
+        result.insert("month", firstDay);
+        result.insert("ledgerCount", names.size());
+        if (ok) {
+            const qint64 net = summary.incomeCents - summary.expensesCents;
+            result.insert("incomeCents", summary.incomeCents);
+            result.insert("expensesCents", summary.expensesCents);
+            result.insert("netCents", net);
+            result.insert("incomeFormatted", formatCents(summary.incomeCents));
+            result.insert("expensesFormatted", formatCents(summary.expensesCents));
+            result.insert("netFormatted", formatCents(net));
+        } else {
+            qWarning() << "Cross-ledger summary failed:" << errorMessage;
+            result.insert("error", errorMessage);
+        }
+
+        QMetaObject::invokeMethod(
+            this, [this, result]() { emit crossLedgerSummaryReady(result); }, Qt::QueuedConnection);
+    });
+}
+
+void AppController::refreshSummary(bool allowCached)
 {
     if (!m_db.isOpen()) {
         return;
@@ -250,24 +409,39 @@ void AppController::refreshSummary()
     const QDate firstDay(m_currentMonth.year(), m_currentMonth.month(), 1);
     const QDate lastDay = firstDay.addMonths(1).addDays(-1);
 
-    QSqlQuery query(m_db);
-    query.prepare(
-        "SELECT type, SUM(amount_cents) "
-        "FROM transactions WHERE date BETWEEN :startDate AND :endDate GROUP BY type");
-    query.bindValue(":startDate", firstDay.toString("yyyy-MM-dd"));
-    query.bindValue(":endDate", lastDay.toString("yyyy-MM-dd"));
-
+    LedgerCache &cache = m_ledgerCaches[m_currentLedger];
     int income = 0;
     int expenses = 0;
-    if (query.exec()) {
-        while (query.next()) {
-            const int type = query.value(0).toInt();
-            const int amount = query.value(1).toInt();
-            if (type == 1) {
-                income = amount;
-            } else {
-                expenses = amount;
+
+    const auto cached = cache.summaries.constFind(firstDay);
+    if (allowCached && cached != cache.summaries.constEnd()) {
+        income = cached->first;
+        expenses = cached->second;
+    } else {
+        // A fresh read follows a write, which may have moved rows between
+        // months, so every cached month of this ledger is stale.
+        if (!allowCached) {
+            cache.summaries.clear();
+        }
+
+        QSqlQuery query(m_db);
+        query.prepare(
+            "SELECT type, SUM(amount_cents) "
+            "FROM transactions WHERE date BETWEEN :startDate AND :endDate GROUP BY type");
+        query.bindValue(":startDate", firstDay.toString("yyyy-MM-dd"));
+        query.bindValue(":endDate", lastDay.toString("yyyy-MM-dd"));
+
+        if (query.exec()) {
+            while (query.next()) {
+                const int type = query.value(0).toInt();
+                const int amount = query.value(1).toInt();
+                if (type == 1) {
+                    income = amount;
+                } else {
+                    expenses = amount;
+                }
             }
+            cache.summaries.insert(firstDay, qMakePair(income, expenses));
         }
     }
 
@@ -278,11 +452,14 @@ void AppController::refreshSummary()
     }
 }
 
-void AppController::refreshCategories()
+void AppController::refreshCategories(bool allowCached)
 {
     QStringList categories = {"Food", "Transport", "Housing", "Health", "Other"};
 
-    if (m_db.isOpen()) {
+    const auto cached = m_ledgerCaches.constFind(m_currentLedger);
+    if (allowCached && cached != m_ledgerCaches.constEnd() && !cached->categories.isEmpty()) {
+        categories = cached->categories;
+    } else if (m_db.isOpen()) {
         QSqlQuery query(m_db);
         query.prepare("SELECT DISTINCT category FROM transactions ORDER BY category ASC");
         if (query.exec()) {
@@ -292,6 +469,7 @@ void AppController::refreshCategories()
                     categories.append(category);
                 }
             }
+            m_ledgerCaches[m_currentLedger].categories = categories;
         }
     }
 
@@ -301,6 +479,29 @@ void AppController::refreshCategories()
     }
 }
 
+void AppController::refreshLedgers()
+{
+    QString errorMessage;
+    const QStringList ledgers = LedgerManager::ledgerNames(errorMessage);
+    if (!errorMessage.isEmpty()) {
+        qWarning() << "Ledger listing failed:" << errorMessage;
+    }
+
+    if (ledgers != m_ledgers) {
+        m_ledgers = ledgers;
+        emit ledgersChanged();
+    }
+}
+
+void AppController::setDbErrorMessage(const QString &message)
+{
+    if (message == m_dbErrorMessage) {
+        return;
+    }
+    m_dbErrorMessage = message;
+    emit dbErrorMessageChanged();
+}
+
 void AppController::clearUndo()
 {
     if (!m_undoAvailable) {
@@ -311,7 +512,7 @@ void AppController::clearUndo()
     m_undoTimer.stop();
 }
 
-QString AppController::formatCents(int cents) const
+QString AppController::formatCents(qint64 cents) const
 {
     const QLocale locale;
     const double amount = static_cast<double>(cents) / 100.0;
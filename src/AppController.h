@@ -1,11 +1,16 @@
 #pragma once
 
+#include "analysis/AnomalyDetector.h"
 #include "models/TransactionsModel.h"
+#include "reports/ReportExporter.h"
 
 #include <QDate>
+#include <QHash>
 #include <QObject>
 #include <QSqlDatabase>
+#include <QThreadPool>
 #include <QTimer>
+#include <QVariantMap>
 
 class AppController : public QObject
 {
@@ -19,11 +24,16 @@ class AppController : public QObject
     Q_PROPERTY(int summaryNetCents READ summaryNetCents NOTIFY summaryChanged)
     Q_PROPERTY(QStringList categories READ categories NOTIFY categoriesChanged)
     Q_PROPERTY(TransactionsModel *transactionsModel READ transactionsModel CONSTANT)
+    Q_PROPERTY(ReportExporter *reportExporter READ reportExporter CONSTANT)
+    Q_PROPERTY(AnomalyDetector *anomalyDetector READ anomalyDetector CONSTANT)
     Q_PROPERTY(bool undoAvailable READ undoAvailable NOTIFY undoAvailableChanged)
     Q_PROPERTY(QString dbErrorMessage READ dbErrorMessage NOTIFY dbErrorMessageChanged)
+    Q_PROPERTY(QStringList ledgers READ ledgers NOTIFY ledgersChanged)
+    Q_PROPERTY(QString currentLedger READ currentLedger NOTIFY currentLedgerChanged)
 
 public:
     explicit AppController(QObject *parent = nullptr);
+    ~AppController() override;
 
     QDate currentMonth() const;
 
@@ -37,10 +47,15 @@ public:
     QStringList categories() const;
 
     TransactionsModel *transactionsModel();
+    ReportExporter *reportExporter();
+    AnomalyDetector *anomalyDetector();
 
     bool undoAvailable() const;
     QString dbErrorMessage() const;
 
+    QStringList ledgers() const;
+    QString currentLedger() const;
+
     Q_INVOKABLE void nextMonth();
     Q_INVOKABLE void prevMonth();
     Q_INVOKABLE void setMonth(const QDate &month);
@@ -51,9 +66,16 @@ public:
                                        const QString &category, const QString &note);
     Q_INVOKABLE bool deleteTransaction(int id);
     Q_INVOKABLE bool undoDelete();
+    // Deletes a row flagged by duplicateDetected(), but only while `ledger`
+    // is still the open ledger.
+    Q_INVOKABLE bool removeDuplicate(const QString &ledger, int transactionId);
 
     Q_INVOKABLE void setFilters(int typeFilter, const QString &categoryFilter, const QString &textFilter);
 
+    Q_INVOKABLE bool switchLedger(const QString &name);
+    Q_INVOKABLE bool createLedger(const QString &name);
+    Q_INVOKABLE void requestCrossLedgerSummary(const QStringList &ledgers);
+
 signals:
     void currentMonthChanged();
     void summaryChanged();
@@ -61,6 +83,10 @@ signals:
     void undoAvailableChanged();
     void dbErrorMessageChanged();
     void transactionDeleted();
+    void ledgersChanged();
+    void currentLedgerChanged();
+    void crossLedgerSummaryReady(const QVariantMap &summary);
+    void duplicateDetected(const QString &ledger, int transactionId, int relatedId);
 
 private:
     struct DeletedTransaction {
@@ -73,13 +99,24 @@ private:
         QString createdAt;
     };
 
-    void refreshSummary();
-    void refreshCategories();
+    // Summaries and categories already computed for a ledger, kept so that
+    // switching back to it or revisiting a month does not hit the database.
+    struct LedgerCache {
+        QStringList categories;
+        QHash<QDate, QPair<int, int>> summaries;
+    };
+
+    void refreshSummary(bool allowCached = false);
+    void refreshCategories(bool allowCached = false);
+    void refreshLedgers();
+    void setDbErrorMessage(const QString &message);
     void clearUndo();
-    QString formatCents(int cents) const;
+    QString formatCents(qint64 cents) const;
 
     QSqlDatabase m_db;
     TransactionsModel m_model;
+    ReportExporter m_reportExporter;
+    AnomalyDetector m_anomalyDetector;
     QDate m_currentMonth;
     int m_summaryIncome = 0;
     int m_summaryExpenses = 0;
@@ -88,4 +125,8 @@ private:
     bool m_undoAvailable = false;
     QString m_dbErrorMessage;
     QTimer m_undoTimer;
+    QStringList m_ledgers;
+    QString m_currentLedger;
+    QHash<QString, LedgerCache> m_ledgerCaches;
+    QThreadPool m_summaryPool;
 };
@@ -0,0 +1,238 @@
+#include "AnomalyDetector.h"
+
+#include "db/Database.h"
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include <utility>
+
+namespace {
+constexpr int kSupersededCheckInterval = 4096;
+}
+
+AnomalyDetector::AnomalyDetector(QObject *parent)
+    : QObject(parent)
+    , m_latestGeneration(std::make_shared<std::atomic_int>(0))
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+AnomalyDetector::~AnomalyDetector()
+{
+    // Any running scan sees a newer generation and stops early.
+    m_latestGeneration->fetch_add(1);
+    m_pool.waitForDone();
+}
+
+void AnomalyDetector::setDatabasePath(const QString &path)
+{
+    if (path == m_databasePath) {
+        return;
+    }
+
+    // A scan of the ledger we are leaving is dropped rather than cached; it
+    // is redone if that ledger is opened again.
+    m_latestGeneration->fetch_add(1);
+    m_pendingChanges.clear();
+    setScanning(false);
+    setLastError(QString());
+    m_databasePath = path;
+
+    const auto cached = m_indexes.constFind(path);
+    if (cached != m_indexes.cend()) {
+        m_model.setFindings(cached->findings());
+        return;
+    }
+
+    m_model.setFindings({});
+    rescan();
+}
+
+FindingsModel *AnomalyDetector::findingsModel()
+{
+    return &m_model;
+}
+
+bool AnomalyDetector::scanning() const
+{
+    return m_scanning;
+}
+
+QString AnomalyDetector::lastError() const
+{
+    return m_lastError;
+}
+
+void AnomalyDetector::rescan()
+{
+    if (m_databasePath.isEmpty()) {
+        return;
+    }
+
+    m_indexes.remove(m_databasePath);
+    m_pendingChanges.clear();
+    setLastError(QString());
+    const int generation = m_latestGeneration->fetch_add(1) + 1;
+    setScanning(true);
+
+    const QString databasePath = m_databasePath;
+    const std::shared_ptr<std::atomic_int> latestGeneration = m_latestGeneration;
+    m_pool.start([this, databasePath, latestGeneration, generation]() {
+        const std::shared_ptr<ScanResult> result = scan(databasePath, latestGeneration, generation);
+        QMetaObject::invokeMethod(
+            this, [this, generation, result]() { finishScan(generation, result); }, Qt::QueuedConnection);
+    });
+}
+
+void AnomalyDetector::checkTransaction(int id, int type, qint64 amountCents, const QDate &date,
+                                       const QString &category, const QString &note)
+{
+    queueChange({Change::Insert, id, type, amountCents, date, category, note});
+}
+
+void AnomalyDetector::updateTransaction(int id, int type, qint64 amountCents, const QDate &date,
+                                        const QString &category, const QString &note)
+{
+    queueChange({Change::Update, id, type, amountCents, date, category, note});
+}
+
+void AnomalyDetector::removeTransaction(int id)
+{
+    Change change;
+    change.kind = Change::Remove;
+    change.id = id;
+    queueChange(change);
+}
+
+void AnomalyDetector::queueChange(const Change &change)
+{
+    if (m_scanning) {
+        m_pendingChanges.append(change);
+        return;
+    }
+
+    const auto index = m_indexes.find(m_databasePath);
+    if (index == m_indexes.end()) {
+        // The last scan failed; a retry reads this change from the ledger.
+        return;
+    }
+
+    const FindingChanges changes = applyChange(*index, change);
+    m_model.applyChanges(changes);
+    reportDuplicates(newDuplicates(change, changes));
+}
+
+// Adds replace any row with the same id and removes ignore unknown ids, so a
+// change is safe to apply whether or not a scan already saw it.
+FindingChanges AnomalyDetector::applyChange(AnomalyIndex &index, const Change &change)
+{
+    if (change.kind == Change::Remove) {
+        return index.remove(change.id);
+    }
+    return index.add(change.id, change.type, change.amountCents, change.date, change.category, change.note);
+}
+
+// Only a newly inserted row prompts the user; edits and restores do not.
+QList<Finding> AnomalyDetector::newDuplicates(const Change &change, const FindingChanges &changes)
+{
+    QList<Finding> duplicates;
+    if (change.kind != Change::Insert) {
+        return duplicates;
+    }
+    for (const Finding &finding : changes.added) {
+        if (finding.transactionId == change.id && finding.kind != Finding::Outlier) {
+            duplicates.append(finding);
+        }
+    }
+    return duplicates;
+}
+
+void AnomalyDetector::reportDuplicates(const QList<Finding> &duplicates)
+{
+    for (const Finding &finding : duplicates) {
+        emit duplicateDetected(finding.transactionId, finding.relatedId);
+    }
+}
+
+// Runs on the pool thread. Rows are read in date order so every index insert
+// is an append and the pass stays linear in the number of transactions.
+std::shared_ptr<AnomalyDetector::ScanResult> AnomalyDetector::scan(
+    const QString &databasePath, const std::shared_ptr<std::atomic_int> &latestGeneration, int generation)
+{
+    auto result = std::make_shared<ScanResult>();
+
+    QSqlDatabase db = Database::open(databasePath, result->errorMessage);
+    if (!db.isOpen()) {
+        return result;
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, type, amount_cents, date, category, note "
+                    "FROM transactions ORDER BY date ASC, id ASC")) {
+        result->errorMessage = query.lastError().text();
+        return result;
+    }
+
+    int rowCount = 0;
+    while (query.next()) {
+        if (++rowCount % kSupersededCheckInterval == 0 && latestGeneration->load() != generation) {
+            return result;
+        }
+        result->index.add(query.value(0).toInt(), query.value(1).toInt(), query.value(2).toLongLong(),
+                          QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"), query.value(4).toString(),
+                          query.value(5).toString());
+    }
+
+    if (query.lastError().type() != QSqlError::NoError) {
+        result->errorMessage = query.lastError().text();
+        return result;
+    }
+
+    result->ok = true;
+    return result;
+}
+
+void AnomalyDetector::finishScan(int generation, const std::shared_ptr<ScanResult> &result)
+{
+    if (generation != m_latestGeneration->load()) {
+        return;
+    }
+
+    setScanning(false);
+    const QList<Change> pendingChanges = std::exchange(m_pendingChanges, {});
+    if (!result->ok) {
+        qWarning() << "Anomaly scan failed:" << result->errorMessage;
+        setLastError(result->errorMessage);
+        return;
+    }
+
+    AnomalyIndex &index = *m_indexes.insert(m_databasePath, std::move(result->index));
+    QList<Finding> duplicates;
+    for (const Change &change : pendingChanges) {
+        duplicates.append(newDuplicates(change, applyChange(index, change)));
+    }
+
+    m_model.setFindings(index.findings());
+    reportDuplicates(duplicates);
+}
+
+void AnomalyDetector::setScanning(bool scanning)
+{
+    if (scanning == m_scanning) {
+        return;
+    }
+    m_scanning = scanning;
+    emit scanningChanged();
+}
+
+void AnomalyDetector::setLastError(const QString &message)
+{
+    if (message == m_lastError) {
+        return;
+    }
+    m_lastError = message;
+    emit lastErrorChanged();
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "analysis/AnomalyIndex.h"
+#include "models/FindingsModel.h"
+
+#include <QHash>
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+// Keeps an AnomalyIndex per ledger. The first time a ledger is opened a full
+// scan builds its index on a background thread; after that, inserts, edits
+// and deletes are applied to the index directly, and switching back to a
+// ledger reuses the index built earlier.
+class AnomalyDetector : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(FindingsModel *findingsModel READ findingsModel CONSTANT)
+    Q_PROPERTY(bool scanning READ scanning NOTIFY scanningChanged)
+    Q_PROPERTY(QString lastError READ lastError NOTIFY lastErrorChanged)
+
+public:
+    explicit AnomalyDetector(QObject *parent = nullptr);
+    ~AnomalyDetector() override;
+
+    // Publishes the ledger's cached index, or starts a scan if it has none.
+    void setDatabasePath(const QString &path);
+
+    FindingsModel *findingsModel();
+    bool scanning() const;
+    QString lastError() const;
+
+    // Throws away the open ledger's index and scans it again.
+    Q_INVOKABLE void rescan();
+
+    // A newly inserted row; emits duplicateDetected if it copies another one.
+    void checkTransaction(int id, int type, qint64 amountCents, const QDate &date, const QString &category,
+                          const QString &note);
+    // An edited or restored row.
+    void updateTransaction(int id, int type, qint64 amountCents, const QDate &date, const QString &category,
+                           const QString &note);
+    void removeTransaction(int id);
+
+signals:
+    void scanningChanged();
+    void lastErrorChanged();
+    void duplicateDetected(int transactionId, int relatedId);
+
+private:
+    struct Change {
+        enum Kind {
+            Insert,
+            Update,
+            Remove
+        };
+
+        Kind kind = Insert;
+        int id = 0;
+        int type = 0;
+        qint64 amountCents = 0;
+        QDate date;
+        QString category;
+        QString note;
+    };
+
+    struct ScanResult {
+        AnomalyIndex index;
+        bool ok = false;
+        QString errorMessage;
+    };
+
+    static std::shared_ptr<ScanResult> scan(const QString &databasePath,
+                                            const std::shared_ptr<std::atomic_int> &latestGeneration,
+                                            int generation);
+    void finishScan(int generation, const std::shared_ptr<ScanResult> &result);
+    void queueChange(const Change &change);
+    static FindingChanges applyChange(AnomalyIndex &index, const Change &change);
+    static QList<Finding> newDuplicates(const Change &change, const FindingChanges &changes);
+    void reportDuplicates(const QList<Finding> &duplicates);
+    void setScanning(bool scanning);
+    void setLastError(const QString &message);
+
+    QThreadPool m_pool;
+    QString m_databasePath;
+    FindingsModel m_model;
+    QHash<QString, AnomalyIndex> m_indexes;
+    // Changes made while the open ledger is being scanned; replayed onto the
+    // new index because the scan may or may not have read them.
+    QList<Change> m_pendingChanges;
+    bool m_scanning = false;
+    QString m_lastError;
+    std::shared_ptr<std::atomic_int> m_latestGeneration;
+};
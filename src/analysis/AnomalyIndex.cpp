@@ -0,0 +1,252 @@
+#include "AnomalyIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+FindingChanges AnomalyIndex::add(int id, int type, qint64 amountCents, const QDate &date,
+                                 const QString &category, const QString &note)
+{
+    FindingChanges changes;
+    removeRecord(id, changes);
+
+    Record record;
+    record.type = type;
+    record.amountCents = amountCents;
+    record.date = date;
+    record.category = category;
+    record.normalizedCategory = normalize(category);
+    record.normalizedNote = normalize(note);
+    record.signature = qHashMulti(0, type, amountCents, record.normalizedCategory, record.normalizedNote);
+    m_records.insert(id, record);
+
+    const Key key{date.toJulianDay(), id};
+
+    // upper_bound keeps rows fed in date order appending at the end.
+    std::vector<Key> &bucket = m_signatures[record.signature];
+    bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), key), key);
+    m_categories[qMakePair(type, record.normalizedCategory)].emplace(key, amountCents);
+
+    refreshFrom(record, key, changes);
+
+    // Replacing a row with an equivalent one can drop and restore the same
+    // finding; report only what actually differs.
+    for (qsizetype i = changes.added.size() - 1; i >= 0; --i) {
+        const Finding &added = changes.added.at(i);
+        const auto match = std::find_if(changes.removed.begin(), changes.removed.end(),
+                                        [&added](const Finding &removed) { return sameFinding(removed, added); });
+        if (match != changes.removed.end()) {
+            changes.removed.erase(match);
+            changes.added.removeAt(i);
+        }
+    }
+    return changes;
+}
+
+FindingChanges AnomalyIndex::remove(int id)
+{
+    FindingChanges changes;
+    removeRecord(id, changes);
+    return changes;
+}
+
+QList<Finding> AnomalyIndex::findings() const
+{
+    QList<Finding> findings;
+    findings.reserve(m_duplicates.size() + m_outliers.size());
+    for (const Finding &finding : m_duplicates) {
+        findings.append(finding);
+    }
+    for (const Finding &finding : m_outliers) {
+        findings.append(finding);
+    }
+
+    std::sort(findings.begin(), findings.end(), lessThan);
+    return findings;
+}
+
+bool AnomalyIndex::lessThan(const Finding &a, const Finding &b)
+{
+    if (a.date != b.date) {
+        return a.date < b.date;
+    }
+    if (a.transactionId != b.transactionId) {
+        return a.transactionId < b.transactionId;
+    }
+    return a.kind < b.kind;
+}
+
+// Case-folds and collapses punctuation and whitespace, so "UBER *Trip" and
+// "uber trip" produce the same signature.
+QString AnomalyIndex::normalize(const QString &text)
+{
+    QString normalized;
+    normalized.reserve(text.size());
+    for (const QChar c : text) {
+        if (c.isLetterOrNumber()) {
+            normalized += c.toCaseFolded();
+        } else if (!normalized.isEmpty() && !normalized.endsWith(' ')) {
+            normalized += ' ';
+        }
+    }
+    return normalized.trimmed();
+}
+
+// Signatures are only hashes, so rows sharing a bucket are compared field by
+// field before one is reported as a copy of the other.
+bool AnomalyIndex::sameFields(const Record &a, const Record &b)
+{
+    return a.type == b.type && a.amountCents == b.amountCents && a.normalizedCategory == b.normalizedCategory
+        && a.normalizedNote == b.normalizedNote;
+}
+
+bool AnomalyIndex::sameFinding(const Finding &a, const Finding &b)
+{
+    return a.kind == b.kind && a.transactionId == b.transactionId && a.relatedId == b.relatedId
+        && a.date == b.date && a.category == b.category && a.amountCents == b.amountCents
+        && a.medianCents == b.medianCents;
+}
+
+Finding AnomalyIndex::makeFinding(Finding::Kind kind, int id, const Record &record) const
+{
+    Finding finding;
+    finding.kind = kind;
+    finding.transactionId = id;
+    finding.date = record.date;
+    finding.category = record.category;
+    finding.amountCents = record.amountCents;
+    return finding;
+}
+
+void AnomalyIndex::removeRecord(int id, FindingChanges &changes)
+{
+    const auto it = m_records.constFind(id);
+    if (it == m_records.cend()) {
+        return;
+    }
+
+    const Record record = *it;
+    const Key key{record.date.toJulianDay(), id};
+    m_records.erase(it);
+    setFinding(m_duplicates, id, nullptr, changes);
+    setFinding(m_outliers, id, nullptr, changes);
+
+    const auto bucket = m_signatures.find(record.signature);
+    if (bucket != m_signatures.end()) {
+        const auto entry = std::lower_bound(bucket->begin(), bucket->end(), key);
+        if (entry != bucket->end() && entry->id == id) {
+            bucket->erase(entry);
+        }
+        if (bucket->empty()) {
+            m_signatures.erase(bucket);
+        }
+    }
+
+    const auto category = m_categories.find(qMakePair(record.type, record.normalizedCategory));
+    if (category != m_categories.end()) {
+        category->erase(key);
+        if (category->empty()) {
+            m_categories.erase(category);
+        }
+    }
+
+    refreshFrom(record, key, changes);
+}
+
+// Rows only ever look back, so a change at `key` can only affect rows at or
+// after it: those within kNearDuplicateDays in its bucket and the next
+// kMedianWindow rows in its category.
+void AnomalyIndex::refreshFrom(const Record &record, const Key &key, FindingChanges &changes)
+{
+    const auto bucket = m_signatures.constFind(record.signature);
+    if (bucket != m_signatures.cend()) {
+        for (auto it = std::lower_bound(bucket->begin(), bucket->end(), key);
+             it != bucket->end() && it->day <= key.day + kNearDuplicateDays; ++it) {
+            evaluateDuplicate(it->id, changes);
+        }
+    }
+
+    const auto category = m_categories.constFind(qMakePair(record.type, record.normalizedCategory));
+    if (category != m_categories.cend()) {
+        auto it = category->lower_bound(key);
+        for (int i = 0; it != category->end() && i <= kMedianWindow; ++it, ++i) {
+            evaluateOutlier(it->first.id, changes);
+        }
+    }
+}
+
+void AnomalyIndex::evaluateDuplicate(int id, FindingChanges &changes)
+{
+    const Record &record = *m_records.constFind(id);
+    const Key key{record.date.toJulianDay(), id};
+    const std::vector<Key> &bucket = *m_signatures.constFind(record.signature);
+
+    int exactId = 0;
+    int nearId = 0;
+    for (auto it = std::lower_bound(bucket.begin(), bucket.end(),
+                                    Key{key.day - kNearDuplicateDays, std::numeric_limits<int>::min()});
+         it != bucket.end() && *it < key; ++it) {
+        if (!sameFields(record, *m_records.constFind(it->id))) {
+            continue;
+        }
+        if (it->day == key.day) {
+            exactId = exactId == 0 ? it->id : exactId;
+        } else {
+            nearId = nearId == 0 ? it->id : nearId;
+        }
+    }
+
+    if (exactId == 0 && nearId == 0) {
+        setFinding(m_duplicates, id, nullptr, changes);
+        return;
+    }
+
+    Finding finding = makeFinding(exactId != 0 ? Finding::ExactDuplicate : Finding::NearDuplicate, id, record);
+    finding.relatedId = exactId != 0 ? exactId : nearId;
+    setFinding(m_duplicates, id, &finding, changes);
+}
+
+void AnomalyIndex::evaluateOutlier(int id, FindingChanges &changes)
+{
+    const Record &record = *m_records.constFind(id);
+    const std::map<Key, qint64> &rows = *m_categories.constFind(qMakePair(record.type, record.normalizedCategory));
+
+    std::vector<qint64> window;
+    window.reserve(kMedianWindow);
+    for (auto it = rows.find(Key{record.date.toJulianDay(), id});
+         it != rows.begin() && window.size() < static_cast<size_t>(kMedianWindow);) {
+        --it;
+        window.push_back(it->second);
+    }
+
+    if (window.size() >= static_cast<size_t>(kMinOutlierSamples)) {
+        std::sort(window.begin(), window.end());
+        const size_t mid = window.size() / 2;
+        const qint64 median = window.size() % 2 == 1 ? window[mid] : (window[mid - 1] + window[mid]) / 2;
+        if (median > 0 && record.amountCents > median * kOutlierFactor) {
+            Finding finding = makeFinding(Finding::Outlier, id, record);
+            finding.medianCents = median;
+            setFinding(m_outliers, id, &finding, changes);
+            return;
+        }
+    }
+
+    setFinding(m_outliers, id, nullptr, changes);
+}
+
+// Stores or clears the finding for `id` and records the difference.
+void AnomalyIndex::setFinding(QHash<int, Finding> &findings, int id, const Finding *finding,
+                              FindingChanges &changes)
+{
+    const auto existing = findings.find(id);
+    if (existing != findings.end()) {
+        if (finding && sameFinding(*existing, *finding)) {
+            return;
+        }
+        changes.removed.append(*existing);
+        findings.erase(existing);
+    }
+    if (finding) {
+        findings.insert(id, *finding);
+        changes.added.append(*finding);
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+#include <map>
+#include <vector>
+
+struct Finding {
+    enum Kind {
+        ExactDuplicate,
+        NearDuplicate,
+        Outlier
+    };
+
+    Kind kind = ExactDuplicate;
+    int transactionId = 0;
+    int relatedId = 0;
+    QDate date;
+    QString category;
+    qint64 amountCents = 0;
+    qint64 medianCents = 0;
+};
+
+// What one add() or remove() did to the set of findings. A finding whose
+// details changed appears in both lists.
+struct FindingChanges {
+    QList<Finding> removed;
+    QList<Finding> added;
+};
+
+// Duplicate and outlier detection over a ledger's transactions, kept up to
+// date as rows are added, edited and removed.
+//
+// Rows are bucketed by a hash of (type, amount, normalized category, normalized
+// note) and ordered by (day, id) within each bucket. A row is a duplicate of an
+// earlier row in its bucket with the same fields: an exact one on the same day,
+// a near one within kNearDuplicateDays. Each (type, category) keeps its rows in
+// the same order, and a row far above the median of the kMedianWindow rows
+// before it is an outlier.
+//
+// A change only re-evaluates the rows whose window it falls into, so adding or
+// removing a row costs O(bucket + kMedianWindow^2) and a full scan fed in date
+// order stays linear in ledger size.
+class AnomalyIndex
+{
+public:
+    static constexpr int kNearDuplicateDays = 2;
+    static constexpr int kMedianWindow = 31;
+    static constexpr int kMinOutlierSamples = 8;
+    static constexpr int kOutlierFactor = 3;
+
+    // Adding an id that is already indexed replaces it.
+    FindingChanges add(int id, int type, qint64 amountCents, const QDate &date, const QString &category,
+                       const QString &note);
+    FindingChanges remove(int id);
+
+    // All current findings in lessThan() order.
+    QList<Finding> findings() const;
+
+    // Orders findings by date, then transaction, then kind.
+    static bool lessThan(const Finding &a, const Finding &b);
+
+    static QString normalize(const QString &text);
+
+private:
+    struct Key {
+        qint64 day = 0;
+        int id = 0;
+
+        bool operator<(const Key &other) const
+        {
+            return day != other.day ? day < other.day : id < other.id;
+        }
+    };
+
+    struct Record {
+        int type = 0;
+        qint64 amountCents = 0;
+        QDate date;
+        QString category;
+        QString normalizedCategory;
+        QString normalizedNote;
+        size_t signature = 0;
+    };
+
+    using CategoryKey = QPair<int, QString>;
+
+    static bool sameFields(const Record &a, const Record &b);
+    static bool sameFinding(const Finding &a, const Finding &b);
+    Finding makeFinding(Finding::Kind kind, int id, const Record &record) const;
+    void removeRecord(int id, FindingChanges &changes);
+    void refreshFrom(const Record &record, const Key &key, FindingChanges &changes);
+    void evaluateDuplicate(int id, FindingChanges &changes);
+    void evaluateOutlier(int id, FindingChanges &changes);
+    static void setFinding(QHash<int, Finding> &findings, int id, const Finding *finding,
+                           FindingChanges &changes);
+
+    QHash<int, Record> m_records;
+    QHash<size_t, std::vector<Key>> m_signatures;
+    QHash<CategoryKey, std::map<Key, qint64>> m_categories;
+    QHash<int, Finding> m_duplicates;
+    QHash<int, Finding> m_outliers;
+};
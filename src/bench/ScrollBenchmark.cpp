@@ -0,0 +1,201 @@
+#include "ScrollBenchmark.h"
+
+#include "db/Database.h"
+#include "models/TransactionsModel.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QQmlApplicationEngine>
+#include <QQmlContext>
+#include <QRandomGenerator>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+constexpr qint64 kFrameBudget60Hz = 16666667;
+constexpr qint64 kFrameBudget30Hz = 33333333;
+
+double toMs(qint64 nanoseconds)
+{
+    return static_cast<double>(nanoseconds) / 1e6;
+}
+}
+
+ScrollBenchmark::ScrollBenchmark(const Options &options, QObject *parent)
+    : QObject(parent)
+    , m_options(options)
+{
+}
+
+int ScrollBenchmark::run(const Options &options)
+{
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        qWarning() << "Benchmark temp dir failed:" << dir.errorString();
+        return 1;
+    }
+
+    const QString path = dir.filePath("scroll-benchmark.sqlite");
+    const int exitCode = runOnLedger(path, options);
+    // Every handle to the ledger died with runOnLedger(); the pooled
+    // connection itself must go before the directory is removed.
+    Database::close(path);
+    return exitCode;
+}
+
+int ScrollBenchmark::runOnLedger(const QString &path, const Options &options)
+{
+    // All rows land in one month because the model shows a month at a time.
+    const QDate month(2024, 1, 1);
+    QString errorMessage;
+    QSqlDatabase db = Database::open(path, errorMessage);
+    if (!db.isOpen() || !seed(db, options.rows, month, errorMessage)) {
+        qWarning() << "Benchmark ledger setup failed:" << errorMessage;
+        return 1;
+    }
+
+    TransactionsModel model;
+    model.setDatabase(db);
+    model.setMonth(month);
+
+    ScrollBenchmark benchmark(options);
+
+    QQmlApplicationEngine engine;
+    engine.rootContext()->setContextProperty("benchModel", &model);
+    engine.rootContext()->setContextProperty("benchmark", &benchmark);
+    engine.rootContext()->setContextProperty("benchNativeDelegate", options.nativeDelegate);
+    engine.rootContext()->setContextProperty(
+        "benchDistance", static_cast<double>(options.pixelsPerSecond) * options.durationMs / 1000.0);
+    engine.rootContext()->setContextProperty("benchDuration", options.durationMs);
+    engine.loadFromModule("ExpenseTracker", "ScrollBenchmark");
+
+    if (engine.rootObjects().isEmpty()) {
+        return 1;
+    }
+    benchmark.m_window = qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst());
+    if (!benchmark.m_window) {
+        return 1;
+    }
+
+    return QCoreApplication::exec();
+}
+
+void ScrollBenchmark::start()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_intervals.clear();
+        m_intervals.reserve(static_cast<size_t>(m_options.durationMs) / 4);
+        m_lastFrame = -1;
+    }
+    m_timer.start();
+
+    // frameSwapped is emitted on the render thread with the threaded loop,
+    // so the timestamps are taken there and guarded by m_mutex.
+    m_frameConnection = connect(
+        m_window, &QQuickWindow::frameSwapped, this,
+        [this]() {
+            QMutexLocker locker(&m_mutex);
+            const qint64 now = m_timer.nsecsElapsed();
+            if (m_lastFrame >= 0) {
+                m_intervals.push_back(now - m_lastFrame);
+            }
+            m_lastFrame = now;
+        },
+        Qt::DirectConnection);
+}
+
+void ScrollBenchmark::finish()
+{
+    disconnect(m_frameConnection);
+
+    std::vector<qint64> intervals;
+    {
+        QMutexLocker locker(&m_mutex);
+        intervals.swap(m_intervals);
+    }
+    report(std::move(intervals));
+
+    QTimer::singleShot(0, qApp, []() { QCoreApplication::exit(0); });
+}
+
+bool ScrollBenchmark::seed(QSqlDatabase &db, int rows, const QDate &month, QString &errorMessage)
+{
+    static const QStringList categories = {"Food", "Transport", "Housing", "Health", "Other"};
+    static const QStringList notes = {
+        QString(),
+        "Lunch",
+        "Monthly pass",
+        "Groceries for the week, plus a few extras that make this note long enough to elide",
+        "Pharmacy"
+    };
+
+    QRandomGenerator generator(42);
+    const int daysInMonth = month.daysInMonth();
+
+    if (!db.transaction()) {
+        errorMessage = db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.prepare(
+        "INSERT INTO transactions(type, amount_cents, date, category, note, created_at) "
+        "VALUES (:type, :amount_cents, :date, :category, :note, :created_at)");
+    for (int i = 0; i < rows; ++i) {
+        query.bindValue(":type", generator.bounded(10) == 0 ? 1 : 0);
+        query.bindValue(":amount_cents", generator.bounded(100, 250000));
+        query.bindValue(":date", month.addDays(generator.bounded(daysInMonth)).toString("yyyy-MM-dd"));
+        query.bindValue(":category", categories.at(generator.bounded(static_cast<int>(categories.size()))));
+        query.bindValue(":note", notes.at(generator.bounded(static_cast<int>(notes.size()))));
+        query.bindValue(":created_at", "2024-01-01T00:00:00Z");
+        if (!query.exec()) {
+            errorMessage = query.lastError().text();
+            db.rollback();
+            return false;
+        }
+    }
+
+    if (!db.commit()) {
+        errorMessage = db.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+void ScrollBenchmark::report(std::vector<qint64> intervals) const
+{
+    QTextStream out(stdout);
+    out << "scroll benchmark: " << m_options.rows << " rows, "
+        << (m_options.nativeDelegate ? "native" : "qml") << " delegate, " << m_options.durationMs
+        << " ms at " << m_options.pixelsPerSecond << " px/s\n";
+
+    if (intervals.empty()) {
+        out << "no frames recorded\n";
+        return;
+    }
+
+    std::sort(intervals.begin(), intervals.end());
+    const auto percentile = [&intervals](double fraction) {
+        const size_t index = std::min(intervals.size() - 1, static_cast<size_t>(intervals.size() * fraction));
+        return toMs(intervals[index]);
+    };
+    const qint64 total = std::accumulate(intervals.begin(), intervals.end(), qint64(0));
+    const auto over = [&intervals](qint64 budget) {
+        return std::count_if(intervals.begin(), intervals.end(), [budget](qint64 value) { return value > budget; });
+    };
+    const auto over60 = over(kFrameBudget60Hz);
+
+    out << "frames: " << intervals.size() << "  mean: " << toMs(total) / intervals.size()
+        << " ms  p50: " << percentile(0.50) << " ms  p95: " << percentile(0.95) << " ms  p99: "
+        << percentile(0.99) << " ms  max: " << toMs(intervals.back()) << " ms\n";
+    out << "over 16.7 ms: " << over60 << " (" << 100.0 * over60 / intervals.size()
+        << "%)  over 33.3 ms: " << over(kFrameBudget30Hz) << "\n";
+}
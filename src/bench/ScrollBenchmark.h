@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMetaObject>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QQuickWindow>
+#include <QSqlDatabase>
+
+#include <vector>
+
+// Loads a synthetic ledger into TransactionsModel, scrolls the list at a
+// fixed speed and prints frame-time statistics. Started with
+// `ExpenseTracker --scroll-benchmark`; `--delegate qml` measures the old
+// QML delegate for comparison.
+class ScrollBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int rows = 100000;
+        bool nativeDelegate = true;
+        int durationMs = 10000;
+        int pixelsPerSecond = 6000;
+    };
+
+    static int run(const Options &options);
+
+    Q_INVOKABLE void start();
+    Q_INVOKABLE void finish();
+
+private:
+    explicit ScrollBenchmark(const Options &options, QObject *parent = nullptr);
+
+    static int runOnLedger(const QString &path, const Options &options);
+    static bool seed(QSqlDatabase &db, int rows, const QDate &month, QString &errorMessage);
+    void report(std::vector<qint64> intervals) const;
+
+    Options m_options;
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
+    QElapsedTimer m_timer;
+    QMutex m_mutex;
+    std::vector<qint64> m_intervals;
+    qint64 m_lastFrame = -1;
+};
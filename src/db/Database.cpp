@@ -1,48 +1,193 @@
 #include "Database.h"
 
+#include <QCoreApplication>
+#include <QDebug>
 #include <QDir>
+#include <QFileInfo>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QStandardPaths>
+#include <QThread>
 
 namespace {
 constexpr const char *kConnectionName = "expense_tracker_connection";
+constexpr const char *kScratchPath = ":memory:";
+
+QMutex &registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QSet<QString> &migratedPaths()
+{
+    static QSet<QString> paths;
+    return paths;
+}
+
+QSet<QThread *> &trackedThreads()
+{
+    static QSet<QThread *> threads;
+    return threads;
+}
+
+QString threadSuffix(QThread *thread)
+{
+    return QStringLiteral("@%1").arg(reinterpret_cast<quintptr>(thread), 0, 16);
+}
 }
 
 QSqlDatabase Database::open(QString &errorMessage)
 {
-    if (QSqlDatabase::contains(kConnectionName)) {
-        QSqlDatabase existing = QSqlDatabase::database(kConnectionName);
-        if (existing.isOpen()) {
-            return existing;
+    const QString dbPath = defaultLedgerPath(errorMessage);
+    if (dbPath.isEmpty()) {
+        return {};
+    }
+    return open(dbPath, errorMessage);
+}
+
+QSqlDatabase Database::open(const QString &path, QString &errorMessage)
+{
+    return openPooled(QFileInfo(path).absoluteFilePath(), true, errorMessage);
+}
+
+void Database::close(const QString &path)
+{
+    const QString absolutePath = QFileInfo(path).absoluteFilePath();
+    const QString name = connectionName(absolutePath);
+    if (QSqlDatabase::contains(name)) {
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
         }
+        QSqlDatabase::removeDatabase(name);
     }
 
+    // A new file at the same path needs its schema created again.
+    QMutexLocker locker(&registryMutex());
+    migratedPaths().remove(absolutePath);
+}
+
+QSqlDatabase Database::openScratch(QString &errorMessage)
+{
+    return openPooled(kScratchPath, false, errorMessage);
+}
+
+QString Database::dataDirectory(QString &errorMessage)
+{
     const QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir dir(dataDir);
     if (!dir.exists() && !dir.mkpath(".")) {
         errorMessage = QObject::tr("Unable to create data directory: %1").arg(dataDir);
         return {};
     }
+    return dir.absolutePath();
+}
+
+QString Database::defaultLedgerPath(QString &errorMessage)
+{
+    const QString dataDir = dataDirectory(errorMessage);
+    if (dataDir.isEmpty()) {
+        return {};
+    }
+    return QDir(dataDir).filePath("expenses.sqlite");
+}
+
+QSqlDatabase Database::openPooled(const QString &path, bool runMigrations, QString &errorMessage)
+{
+    const QString name = connectionName(path);
+    if (QSqlDatabase::contains(name)) {
+        QSqlDatabase existing = QSqlDatabase::database(name);
+        if (existing.isOpen()) {
+            return existing;
+        }
+    }
+
+    trackThread();
 
-    const QString dbPath = dir.filePath("expenses.sqlite");
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kConnectionName);
-    db.setDatabaseName(dbPath);
+    QSqlDatabase db = QSqlDatabase::contains(name) ? QSqlDatabase::database(name, false)
+                                                   : QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(path);
 
     if (!db.open()) {
         errorMessage = db.lastError().text();
         return {};
     }
 
-    if (!migrate(db, errorMessage)) {
-        db.close();
-        return {};
+    if (runMigrations) {
+        // Held across migrate() so two threads opening a fresh ledger at once
+        // cannot both try to create the schema.
+        QMutexLocker locker(&registryMutex());
+        if (!migratedPaths().contains(path)) {
+            // WAL lets background readers (exports, scans, summaries) keep a
+            // snapshot open while the GUI thread commits writes. The mode is
+            // stored in the file, so this only needs to run once per ledger.
+            QSqlQuery walQuery(db);
+            if (!walQuery.exec("PRAGMA journal_mode=WAL")) {
+                qWarning() << "Enabling WAL failed:" << path << walQuery.lastError().text();
+            }
+            walQuery.finish();
+
+            if (!migrate(db, errorMessage)) {
+                db.close();
+                return {};
+            }
+            migratedPaths().insert(path);
+        }
     }
 
     return db;
 }
 
+QString Database::connectionName(const QString &path)
+{
+    return QStringLiteral("%1:%2%3")
+        .arg(QLatin1String(kConnectionName), path, threadSuffix(QThread::currentThread()));
+}
+
+void Database::trackThread()
+{
+    QThread *thread = QThread::currentThread();
+    const QCoreApplication *app = QCoreApplication::instance();
+    if (app && thread == app->thread()) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&registryMutex());
+        if (trackedThreads().contains(thread)) {
+            return;
+        }
+        trackedThreads().insert(thread);
+    }
+
+    // Connections may only be used from the thread that created them, so a
+    // worker's pool entries are dropped when that worker exits.
+    const QString suffix = threadSuffix(thread);
+    QObject::connect(
+        thread, &QThread::finished, thread,
+        [thread, suffix]() {
+            const QStringList names = QSqlDatabase::connectionNames();
+            for (const QString &name : names) {
+                if (!name.endsWith(suffix)) {
+                    continue;
+                }
+                {
+                    QSqlDatabase db = QSqlDatabase::database(name, false);
+                    db.close();
+                }
+                QSqlDatabase::removeDatabase(name);
+            }
+
+            QMutexLocker locker(&registryMutex());
+            trackedThreads().remove(thread);
+        },
+        Qt::DirectConnection);
+}
+
 bool Database::migrate(QSqlDatabase &db, QString &errorMessage)
 {
     QSqlQuery pragmaQuery(db);
@@ -8,6 +8,25 @@ class Database
 public:
     static QSqlDatabase open(QString &errorMessage);
 
+    // Returns the calling thread's pooled connection to the ledger file at
+    // `path`, opening it on first use. The schema check runs once per file
+    // per process, so reopening or switching back to a ledger is cheap.
+    static QSqlDatabase open(const QString &path, QString &errorMessage);
+
+    // Closes and removes the calling thread's pooled connection to `path`.
+    // Call before deleting the file; copies of the handle must be gone first.
+    static void close(const QString &path);
+
+    // Returns the calling thread's in-memory connection used as the main
+    // schema when attaching several ledgers into one query.
+    static QSqlDatabase openScratch(QString &errorMessage);
+
+    static QString dataDirectory(QString &errorMessage);
+    static QString defaultLedgerPath(QString &errorMessage);
+
 private:
+    static QSqlDatabase openPooled(const QString &path, bool runMigrations, QString &errorMessage);
+    static QString connectionName(const QString &path);
+    static void trackThread();
     static bool migrate(QSqlDatabase &db, QString &errorMessage);
 };
@@ -0,0 +1,231 @@
+#include "LedgerManager.h"
+
+#include "Database.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QObject>
+#include <QRegularExpression>
+#include <QSemaphore>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadPool>
+
+#include <vector>
+
+namespace {
+// SQLite's default SQLITE_MAX_ATTACHED is 10; stay below it.
+constexpr int kMaxAttachedPerBatch = 8;
+constexpr const char *kLedgerSuffix = ".sqlite";
+
+bool isValidLedgerName(const QString &name)
+{
+    static const QRegularExpression pattern("^\\w[\\w \\-]{0,63}$");
+    return pattern.match(name).hasMatch();
+}
+}
+
+QString LedgerManager::defaultLedgerName()
+{
+    return QStringLiteral("Default");
+}
+
+QStringList LedgerManager::ledgerNames(QString &errorMessage)
+{
+    QStringList names = {defaultLedgerName()};
+
+    const QString dirPath = ledgersDirectory(errorMessage);
+    if (dirPath.isEmpty()) {
+        return names;
+    }
+
+    const QFileInfoList files = QDir(dirPath).entryInfoList(
+        {QStringLiteral("*%1").arg(QLatin1String(kLedgerSuffix))}, QDir::Files, QDir::Name);
+    for (const QFileInfo &file : files) {
+        const QString name = file.completeBaseName();
+        if (name != defaultLedgerName() && isValidLedgerName(name)) {
+            names.append(name);
+        }
+    }
+
+    return names;
+}
+
+QString LedgerManager::ledgerPath(const QString &name, QString &errorMessage)
+{
+    if (name.isEmpty() || name == defaultLedgerName()) {
+        return Database::defaultLedgerPath(errorMessage);
+    }
+
+    if (!isValidLedgerName(name)) {
+        errorMessage = QObject::tr("Invalid ledger name: %1").arg(name);
+        return {};
+    }
+
+    const QString dirPath = ledgersDirectory(errorMessage);
+    if (dirPath.isEmpty()) {
+        return {};
+    }
+    return QDir(dirPath).filePath(name + QLatin1String(kLedgerSuffix));
+}
+
+bool LedgerManager::createLedger(const QString &name, QString &errorMessage)
+{
+    const QString path = ledgerPath(name, errorMessage);
+    if (path.isEmpty()) {
+        return false;
+    }
+
+    if (QFileInfo::exists(path)) {
+        errorMessage = QObject::tr("A ledger named %1 already exists").arg(name);
+        return false;
+    }
+
+    return Database::open(path, errorMessage).isOpen();
+}
+
+bool LedgerManager::summarize(const QStringList &names, const QDate &firstDay, const QDate &lastDay,
+                              Summary &summary, QString &errorMessage)
+{
+    QStringList paths;
+    for (const QString &name : names) {
+        const QString path = ledgerPath(name, errorMessage);
+        if (path.isEmpty()) {
+            return false;
+        }
+        if (name != defaultLedgerName() && !QFileInfo::exists(path)) {
+            errorMessage = QObject::tr("Ledger %1 no longer exists").arg(name);
+            return false;
+        }
+        // Makes sure the schema exists before another thread attaches the file.
+        if (!Database::open(path, errorMessage).isOpen()) {
+            return false;
+        }
+        if (!paths.contains(path)) {
+            paths.append(path);
+        }
+    }
+
+    // One batch per core so even a handful of ledgers is read in parallel,
+    // but never more attachments per batch than SQLite allows.
+    const int ledgerCount = static_cast<int>(paths.size());
+    const int wantedBatches = qMax(1, qMin(ledgerCount, QThread::idealThreadCount()));
+    const int batchSize = qMin(kMaxAttachedPerBatch, (ledgerCount + wantedBatches - 1) / wantedBatches);
+    std::vector<QStringList> batches;
+    for (int i = 0; i < ledgerCount; i += batchSize) {
+        batches.push_back(paths.mid(i, batchSize));
+    }
+
+    summary = Summary();
+    if (batches.empty()) {
+        return true;
+    }
+    if (batches.size() == 1) {
+        return summarizeBatch(batches.front(), firstDay, lastDay, summary, errorMessage);
+    }
+
+    const int batchCount = static_cast<int>(batches.size());
+    std::vector<Summary> results(batches.size());
+    std::vector<QString> errors(batches.size());
+    std::vector<char> succeeded(batches.size(), 0);
+    QSemaphore done;
+
+    // The first batch runs on the calling thread while the rest run on the
+    // global pool, so the caller does useful work instead of idling.
+    for (int i = 1; i < batchCount; ++i) {
+        QThreadPool::globalInstance()->start([&, i]() {
+            succeeded[i] = summarizeBatch(batches[i], firstDay, lastDay, results[i], errors[i]);
+            done.release();
+        });
+    }
+    succeeded[0] = summarizeBatch(batches[0], firstDay, lastDay, results[0], errors[0]);
+    done.acquire(batchCount - 1);
+
+    for (int i = 0; i < batchCount; ++i) {
+        if (!succeeded[i]) {
+            errorMessage = errors[i];
+            return false;
+        }
+        summary.incomeCents += results[i].incomeCents;
+        summary.expensesCents += results[i].expensesCents;
+    }
+
+    return true;
+}
+
+QString LedgerManager::ledgersDirectory(QString &errorMessage)
+{
+    const QString dataDir = Database::dataDirectory(errorMessage);
+    if (dataDir.isEmpty()) {
+        return {};
+    }
+
+    QDir dir(dataDir);
+    if (!dir.exists("ledgers") && !dir.mkpath("ledgers")) {
+        errorMessage = QObject::tr("Unable to create ledgers directory in %1").arg(dataDir);
+        return {};
+    }
+    return dir.filePath("ledgers");
+}
+
+bool LedgerManager::summarizeBatch(const QStringList &paths, const QDate &firstDay, const QDate &lastDay,
+                                   Summary &summary, QString &errorMessage)
+{
+    QSqlDatabase db = Database::openScratch(errorMessage);
+    if (!db.isOpen()) {
+        return false;
+    }
+
+    QStringList aliases;
+    QStringList selects;
+    bool ok = true;
+
+    QSqlQuery attachQuery(db);
+    for (int i = 0; i < paths.size(); ++i) {
+        const QString alias = QStringLiteral("ledger%1").arg(i);
+        attachQuery.prepare(QStringLiteral("ATTACH DATABASE :path AS %1").arg(alias));
+        attachQuery.bindValue(":path", paths.at(i));
+        if (!attachQuery.exec()) {
+            errorMessage = attachQuery.lastError().text();
+            ok = false;
+            break;
+        }
+        aliases.append(alias);
+        selects.append(QStringLiteral("SELECT type, SUM(amount_cents) FROM %1.transactions "
+                                      "WHERE date BETWEEN :startDate AND :endDate GROUP BY type")
+                           .arg(alias));
+    }
+    attachQuery.finish();
+
+    if (ok) {
+        QSqlQuery query(db);
+        query.prepare(selects.join(" UNION ALL "));
+        query.bindValue(":startDate", firstDay.toString("yyyy-MM-dd"));
+        query.bindValue(":endDate", lastDay.toString("yyyy-MM-dd"));
+
+        if (query.exec()) {
+            while (query.next()) {
+                const int type = query.value(0).toInt();
+                const qint64 amount = query.value(1).toLongLong();
+                if (type == 1) {
+                    summary.incomeCents += amount;
+                } else {
+                    summary.expensesCents += amount;
+                }
+            }
+        } else {
+            errorMessage = query.lastError().text();
+            ok = false;
+        }
+    }
+
+    // Detach even after a failure so the pooled scratch connection is clean
+    // for the next batch that lands on this thread.
+    QSqlQuery detachQuery(db);
+    for (const QString &alias : aliases) {
+        detachQuery.exec(QStringLiteral("DETACH DATABASE %1").arg(alias));
+    }
+
+    return ok;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QDate>
+#include <QString>
+#include <QStringList>
+
+class LedgerManager
+{
+public:
+    struct Summary {
+        qint64 incomeCents = 0;
+        qint64 expensesCents = 0;
+    };
+
+    static QString defaultLedgerName();
+
+    static QStringList ledgerNames(QString &errorMessage);
+    static QString ledgerPath(const QString &name, QString &errorMessage);
+    static bool createLedger(const QString &name, QString &errorMessage);
+
+    // Aggregates income and expenses between `firstDay` and `lastDay` across
+    // the named ledgers. Ledgers are split into up to one batch per core and
+    // attached per batch; extra batches run on the global thread pool and the
+    // per-batch totals are merged once all of them finish. Blocks, so call it off the GUI thread and never from a
+    // global pool thread.
+    static bool summarize(const QStringList &names, const QDate &firstDay, const QDate &lastDay,
+                          Summary &summary, QString &errorMessage);
+
+private:
+    static QString ledgersDirectory(QString &errorMessage);
+    static bool summarizeBatch(const QStringList &paths, const QDate &firstDay, const QDate &lastDay,
+                               Summary &summary, QString &errorMessage);
+};
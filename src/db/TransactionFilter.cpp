@@ -0,0 +1,60 @@
+#include "TransactionFilter.h"
+
+#include <QSqlQuery>
+#include <QStringList>
+
+QString TransactionFilter::whereClause() const
+{
+    QStringList conditions;
+    if (firstDay.isValid() && lastDay.isValid()) {
+        conditions << "date BETWEEN :startDate AND :endDate";
+    } else if (firstDay.isValid()) {
+        conditions << "date >= :startDate";
+    } else if (lastDay.isValid()) {
+        conditions << "date <= :endDate";
+    }
+    if (typeFilter != -1) {
+        conditions << "type = :type";
+    }
+    if (hasCategory()) {
+        conditions << "category = :category";
+    }
+    if (hasText()) {
+        conditions << "(note LIKE :search OR category LIKE :search)";
+    }
+
+    if (conditions.isEmpty()) {
+        return {};
+    }
+    return " WHERE " + conditions.join(" AND ");
+}
+
+void TransactionFilter::bindValues(QSqlQuery &query) const
+{
+    if (firstDay.isValid()) {
+        query.bindValue(":startDate", firstDay.toString("yyyy-MM-dd"));
+    }
+    if (lastDay.isValid()) {
+        query.bindValue(":endDate", lastDay.toString("yyyy-MM-dd"));
+    }
+    if (typeFilter != -1) {
+        query.bindValue(":type", typeFilter);
+    }
+    if (hasCategory()) {
+        query.bindValue(":category", categoryFilter);
+    }
+    if (hasText()) {
+        const QString sanitized = textFilter.trimmed().replace('%', "\\%");
+        query.bindValue(":search", QString("%%1%").arg(sanitized));
+    }
+}
+
+bool TransactionFilter::hasCategory() const
+{
+    return !categoryFilter.isEmpty() && categoryFilter != "All";
+}
+
+bool TransactionFilter::hasText() const
+{
+    return !textFilter.trimmed().isEmpty();
+}
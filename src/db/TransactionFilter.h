@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QDate>
+#include <QString>
+
+class QSqlQuery;
+
+// Filter over the transactions table shared by the list model and the report
+// exporter, so both agree on what "Expense / Food / 'lunch'" selects.
+// An invalid firstDay or lastDay leaves that end of the range open.
+struct TransactionFilter {
+    QDate firstDay;
+    QDate lastDay;
+    int typeFilter = -1;
+    QString categoryFilter;
+    QString textFilter;
+
+    QString whereClause() const;
+    void bindValues(QSqlQuery &query) const;
+
+private:
+    bool hasCategory() const;
+    bool hasText() const;
+};
@@ -1,5 +1,7 @@
 #include "AppController.h"
+#include "bench/ScrollBenchmark.h"
 
+#include <QCommandLineParser>
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
@@ -10,6 +12,22 @@ int main(int argc, char *argv[])
     QGuiApplication app(argc, argv);
     QQuickStyle::setStyle("Material");
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    const QCommandLineOption benchmarkOption("scroll-benchmark",
+                                             "Scroll a synthetic ledger and print frame times.");
+    const QCommandLineOption rowsOption("rows", "Rows in the benchmark ledger.", "count", "100000");
+    const QCommandLineOption delegateOption("delegate", "Benchmark delegate: native or qml.", "kind", "native");
+    parser.addOptions({benchmarkOption, rowsOption, delegateOption});
+    parser.process(app);
+
+    if (parser.isSet(benchmarkOption)) {
+        ScrollBenchmark::Options options;
+        options.rows = qMax(1, parser.value(rowsOption).toInt());
+        options.nativeDelegate = parser.value(delegateOption) != "qml";
+        return ScrollBenchmark::run(options);
+    }
+
     QQmlApplicationEngine engine;
 
     AppController controller;
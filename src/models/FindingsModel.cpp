@@ -0,0 +1,122 @@
+#include "FindingsModel.h"
+
+#include <QLocale>
+
+#include <algorithm>
+
+FindingsModel::FindingsModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void FindingsModel::setFindings(const QList<Finding> &findings)
+{
+    const bool countChanging = findings.count() != m_items.count();
+    beginResetModel();
+    m_items = findings;
+    endResetModel();
+    if (countChanging) {
+        emit countChanged();
+    }
+}
+
+void FindingsModel::applyChanges(const FindingChanges &changes)
+{
+    if (changes.removed.isEmpty() && changes.added.isEmpty()) {
+        return;
+    }
+
+    const qsizetype previousCount = m_items.count();
+    for (const Finding &finding : changes.removed) {
+        const auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), finding, AnomalyIndex::lessThan);
+        if (it == m_items.cend() || AnomalyIndex::lessThan(finding, *it)) {
+            continue;
+        }
+        const int row = static_cast<int>(it - m_items.cbegin());
+        beginRemoveRows(QModelIndex(), row, row);
+        m_items.removeAt(row);
+        endRemoveRows();
+    }
+
+    for (const Finding &finding : changes.added) {
+        const auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), finding, AnomalyIndex::lessThan);
+        const int row = static_cast<int>(it - m_items.cbegin());
+        beginInsertRows(QModelIndex(), row, row);
+        m_items.insert(row, finding);
+        endInsertRows();
+    }
+
+    if (m_items.count() != previousCount) {
+        emit countChanged();
+    }
+}
+
+int FindingsModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_items.count();
+}
+
+QVariant FindingsModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_items.count()) {
+        return {};
+    }
+
+    const Finding &item = m_items.at(index.row());
+    switch (role) {
+    case KindRole:
+        return static_cast<int>(item.kind);
+    case TransactionIdRole:
+        return item.transactionId;
+    case RelatedIdRole:
+        return item.relatedId;
+    case DateRole:
+        return item.date.toString("yyyy-MM-dd");
+    case CategoryRole:
+        return item.category;
+    case AmountFormattedRole:
+        return formatCents(item.amountCents);
+    case DescriptionRole:
+        return describe(item);
+    default:
+        return {};
+    }
+}
+
+QHash<int, QByteArray> FindingsModel::roleNames() const
+{
+    return {
+        {KindRole, "kind"},
+        {TransactionIdRole, "transactionId"},
+        {RelatedIdRole, "relatedId"},
+        {DateRole, "date"},
+        {CategoryRole, "category"},
+        {AmountFormattedRole, "amountFormatted"},
+        {DescriptionRole, "description"}
+    };
+}
+
+QString FindingsModel::formatCents(qint64 cents) const
+{
+    const QLocale locale;
+    const double amount = static_cast<double>(cents) / 100.0;
+    return locale.toString(amount, 'f', 2);
+}
+
+QString FindingsModel::describe(const Finding &finding) const
+{
+    switch (finding.kind) {
+    case Finding::ExactDuplicate:
+        return tr("Same as transaction #%1").arg(finding.relatedId);
+    case Finding::NearDuplicate:
+        return tr("Likely duplicate of transaction #%1").arg(finding.relatedId);
+    case Finding::Outlier:
+        return tr("%1x the usual %2 for %3")
+            .arg(QLocale().toString(static_cast<double>(finding.amountCents) / finding.medianCents, 'f', 1),
+                 formatCents(finding.medianCents), finding.category);
+    }
+    return {};
+}
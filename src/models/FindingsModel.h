@@ -0,0 +1,43 @@
+#pragma once
+
+#include "analysis/AnomalyIndex.h"
+
+#include <QAbstractListModel>
+
+class FindingsModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        KindRole = Qt::UserRole + 1,
+        TransactionIdRole,
+        RelatedIdRole,
+        DateRole,
+        CategoryRole,
+        AmountFormattedRole,
+        DescriptionRole
+    };
+
+    explicit FindingsModel(QObject *parent = nullptr);
+
+    // `findings` must already be in AnomalyIndex::lessThan() order.
+    void setFindings(const QList<Finding> &findings);
+    // Removes and inserts single rows in place, so an open view keeps its
+    // position and the cost does not grow with the number of findings.
+    void applyChanges(const FindingChanges &changes);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void countChanged();
+
+private:
+    QString formatCents(qint64 cents) const;
+    QString describe(const Finding &finding) const;
+
+    QList<Finding> m_items;
+};
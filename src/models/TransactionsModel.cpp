@@ -1,5 +1,7 @@
 #include "TransactionsModel.h"
 
+#include "db/TransactionFilter.h"
+
 #include <QLocale>
 #include <QSqlError>
 #include <QSqlQuery>
@@ -52,15 +54,17 @@ QVariant TransactionsModel::data(const QModelIndex &index, int role) const
     case TypeRole:
         return item.type;
     case AmountFormattedRole:
-        return formatCents(item.amountCents);
+        return item.amountFormatted;
     case AmountCentsRole:
         return item.amountCents;
     case DateRole:
-        return item.date.toString("yyyy-MM-dd");
+        return item.dateFormatted;
     case CategoryRole:
         return item.category;
     case NoteRole:
         return item.note;
+    case RowRole:
+        return QVariant::fromValue(item);
     default:
         return {};
     }
@@ -75,7 +79,8 @@ QHash<int, QByteArray> TransactionsModel::roleNames() const
         {AmountCentsRole, "amountCents"},
         {DateRole, "date"},
         {CategoryRole, "category"},
-        {NoteRole, "note"}
+        {NoteRole, "note"},
+        {RowRole, "row"}
     };
 }
 
@@ -88,38 +93,17 @@ void TransactionsModel::reload()
     beginResetModel();
     m_items.clear();
 
-    const QDate firstDay = QDate(m_month.year(), m_month.month(), 1);
-    const QDate lastDay = firstDay.addMonths(1).addDays(-1);
-
-    QString queryString =
-        "SELECT id, type, amount_cents, date, category, note "
-        "FROM transactions WHERE date BETWEEN :startDate AND :endDate";
-
-    if (m_typeFilter != -1) {
-        queryString += " AND type = :type";
-    }
-    if (!m_categoryFilter.isEmpty() && m_categoryFilter != "All") {
-        queryString += " AND category = :category";
-    }
-    if (!m_textFilter.trimmed().isEmpty()) {
-        queryString += " AND (note LIKE :search OR category LIKE :search)";
-    }
-    queryString += " ORDER BY date DESC, id DESC";
+    TransactionFilter filter;
+    filter.firstDay = QDate(m_month.year(), m_month.month(), 1);
+    filter.lastDay = filter.firstDay.addMonths(1).addDays(-1);
+    filter.typeFilter = m_typeFilter;
+    filter.categoryFilter = m_categoryFilter;
+    filter.textFilter = m_textFilter;
 
     QSqlQuery query(m_db);
-    query.prepare(queryString);
-    query.bindValue(":startDate", firstDay.toString("yyyy-MM-dd"));
-    query.bindValue(":endDate", lastDay.toString("yyyy-MM-dd"));
-    if (m_typeFilter != -1) {
-        query.bindValue(":type", m_typeFilter);
-    }
-    if (!m_categoryFilter.isEmpty() && m_categoryFilter != "All") {
-        query.bindValue(":category", m_categoryFilter);
-    }
-    if (!m_textFilter.trimmed().isEmpty()) {
-        const QString sanitized = m_textFilter.trimmed().replace('%', "\\%");
-        query.bindValue(":search", QString("%%1%").arg(sanitized));
-    }
+    query.prepare("SELECT id, type, amount_cents, date, category, note FROM transactions"
+                  + filter.whereClause() + " ORDER BY date DESC, id DESC");
+    filter.bindValues(query);
 
     if (query.exec()) {
         while (query.next()) {
@@ -127,9 +111,11 @@ void TransactionsModel::reload()
             item.id = query.value(0).toInt();
             item.type = query.value(1).toInt();
             item.amountCents = query.value(2).toInt();
-            item.date = QDate::fromString(query.value(3).toString(), "yyyy-MM-dd");
+            item.dateFormatted = query.value(3).toString();
+            item.date = QDate::fromString(item.dateFormatted, "yyyy-MM-dd");
             item.category = query.value(4).toString();
             item.note = query.value(5).toString();
+            item.amountFormatted = formatCents(item.amountCents);
             m_items.append(item);
         }
     }
@@ -16,7 +16,8 @@ public:
         AmountCentsRole,
         DateRole,
         CategoryRole,
-        NoteRole
+        NoteRole,
+        RowRole
     };
 
     explicit TransactionsModel(QObject *parent = nullptr);
@@ -39,6 +40,9 @@ public:
         QDate date;
         QString category;
         QString note;
+        // Formatted once per reload so delegates never re-run QLocale while scrolling.
+        QString amountFormatted;
+        QString dateFormatted;
     };
 
 private:
@@ -51,3 +55,5 @@ private:
     QString m_categoryFilter;
     QString m_textFilter;
 };
+
+Q_DECLARE_METATYPE(TransactionsModel::Transaction)
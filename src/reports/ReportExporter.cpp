@@ -0,0 +1,259 @@
+#include "ReportExporter.h"
+
+#include "ReportSinks.h"
+#include "db/Database.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QSaveFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QUrl>
+
+#include <algorithm>
+
+namespace {
+constexpr int kProgressInterval = 4096;
+}
+
+ReportExporter::ReportExporter(QObject *parent)
+    : QObject(parent)
+{
+    m_pool.setMaxThreadCount(1);
+}
+
+ReportExporter::~ReportExporter()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+void ReportExporter::setDatabasePath(const QString &path)
+{
+    m_databasePath = path;
+}
+
+bool ReportExporter::running() const
+{
+    return m_running;
+}
+
+double ReportExporter::progress() const
+{
+    return m_progress;
+}
+
+QString ReportExporter::lastError() const
+{
+    return m_lastError;
+}
+
+bool ReportExporter::exportReport(int format, const QString &fileUrl, const QDate &firstDay,
+                                  const QDate &lastDay, int typeFilter, const QString &categoryFilter,
+                                  const QString &textFilter)
+{
+    if (m_running) {
+        return false;
+    }
+
+    const QUrl url(fileUrl);
+    const QString filePath = url.isLocalFile() ? url.toLocalFile() : fileUrl;
+    if (filePath.isEmpty() || format < ReportSink::Csv || format > ReportSink::Pdf) {
+        setLastError(tr("Choose a file and format to export to"));
+        return false;
+    }
+    if (m_databasePath.isEmpty()) {
+        setLastError(tr("No ledger is open"));
+        return false;
+    }
+
+    Job job;
+    job.databasePath = m_databasePath;
+    job.filePath = filePath;
+    job.format = format;
+    job.filter.firstDay = firstDay;
+    job.filter.lastDay = lastDay;
+    job.filter.typeFilter = typeFilter;
+    job.filter.categoryFilter = categoryFilter;
+    job.filter.textFilter = textFilter;
+    if (firstDay.isValid() && lastDay.isValid()) {
+        job.title = tr("Transactions %1 to %2")
+                        .arg(firstDay.toString("yyyy-MM-dd"), lastDay.toString("yyyy-MM-dd"));
+    } else {
+        job.title = tr("Transactions");
+    }
+
+    m_cancelled = std::make_shared<std::atomic_bool>(false);
+    job.cancelled = m_cancelled;
+
+    setLastError(QString());
+    setProgress(0.0);
+    m_running = true;
+    emit runningChanged();
+
+    m_pool.start([this, job]() {
+        int rowCount = 0;
+        QString errorMessage;
+        const bool ok = writeReport(job, rowCount, errorMessage);
+        const bool cancelled = !ok && job.cancelled->load();
+        QMetaObject::invokeMethod(
+            this, [this, ok, cancelled, job, rowCount, errorMessage]() {
+                finishJob(ok, cancelled, job.filePath, rowCount, errorMessage);
+            },
+            Qt::QueuedConnection);
+    });
+
+    return true;
+}
+
+void ReportExporter::clearError()
+{
+    setLastError(QString());
+}
+
+void ReportExporter::cancel()
+{
+    if (m_cancelled) {
+        m_cancelled->store(true);
+    }
+}
+
+// Runs on the pool thread with that thread's own pooled connection.
+bool ReportExporter::writeReport(const Job &job, int &rowCount, QString &errorMessage)
+{
+    QSqlDatabase db = Database::open(job.databasePath, errorMessage);
+    if (!db.isOpen()) {
+        return false;
+    }
+
+    const QString where = job.filter.whereClause();
+
+    qint64 total = 0;
+    {
+        QSqlQuery countQuery(db);
+        countQuery.prepare("SELECT COUNT(*) FROM transactions" + where);
+        job.filter.bindValues(countQuery);
+        if (countQuery.exec() && countQuery.next()) {
+            total = countQuery.value(0).toLongLong();
+        }
+    }
+
+    // Written to a temporary file and only moved into place on success, so
+    // a cancelled or failed export leaves nothing behind.
+    QSaveFile file(job.filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    const std::unique_ptr<ReportSink> sink =
+        ReportSink::create(static_cast<ReportSink::Format>(job.format), &file, job.title);
+    if (!sink->begin(errorMessage)) {
+        file.cancelWriting();
+        return false;
+    }
+
+    // Forward-only keeps the SQLite driver from caching rows already read.
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT id, type, amount_cents, date, category, note FROM transactions" + where
+                  + " ORDER BY date ASC, id ASC");
+    job.filter.bindValues(query);
+    if (!query.exec()) {
+        errorMessage = query.lastError().text();
+        file.cancelWriting();
+        return false;
+    }
+
+    QHash<QString, CategorySubtotal> subtotals;
+    ReportRow row;
+    while (query.next()) {
+        if (job.cancelled->load(std::memory_order_relaxed)) {
+            file.cancelWriting();
+            return false;
+        }
+
+        row.id = query.value(0).toLongLong();
+        row.type = query.value(1).toInt();
+        row.amountCents = query.value(2).toLongLong();
+        row.date = query.value(3).toString();
+        row.category = query.value(4).toString();
+        row.note = query.value(5).toString();
+        if (!sink->writeRow(row, errorMessage)) {
+            file.cancelWriting();
+            return false;
+        }
+
+        CategorySubtotal &subtotal = subtotals[row.category];
+        subtotal.category = row.category;
+        if (row.type == 1) {
+            subtotal.incomeCents += row.amountCents;
+        } else {
+            subtotal.expensesCents += row.amountCents;
+        }
+
+        if (++rowCount % kProgressInterval == 0 && total > 0) {
+            const double progress = qMin(1.0, static_cast<double>(rowCount) / static_cast<double>(total));
+            QMetaObject::invokeMethod(this, [this, progress]() { setProgress(progress); },
+                                      Qt::QueuedConnection);
+        }
+    }
+
+    if (query.lastError().type() != QSqlError::NoError) {
+        errorMessage = query.lastError().text();
+        file.cancelWriting();
+        return false;
+    }
+
+    QList<CategorySubtotal> ordered = subtotals.values();
+    std::sort(ordered.begin(), ordered.end(), [](const CategorySubtotal &a, const CategorySubtotal &b) {
+        return a.category < b.category;
+    });
+
+    if (!sink->finish(ordered, errorMessage)) {
+        file.cancelWriting();
+        return false;
+    }
+
+    if (!file.commit()) {
+        errorMessage = file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void ReportExporter::setProgress(double progress)
+{
+    if (qFuzzyCompare(progress, m_progress)) {
+        return;
+    }
+    m_progress = progress;
+    emit progressChanged();
+}
+
+void ReportExporter::setLastError(const QString &message)
+{
+    if (message == m_lastError) {
+        return;
+    }
+    m_lastError = message;
+    emit lastErrorChanged();
+}
+
+void ReportExporter::finishJob(bool ok, bool cancelled, const QString &filePath, int rowCount,
+                               const QString &errorMessage)
+{
+    if (ok) {
+        setProgress(1.0);
+    } else if (cancelled) {
+        setProgress(0.0);
+    } else {
+        qWarning() << "Report export failed:" << errorMessage;
+        setLastError(errorMessage);
+    }
+
+    m_running = false;
+    emit runningChanged();
+    emit exportFinished(ok, filePath, rowCount);
+}
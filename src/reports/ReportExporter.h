@@ -0,0 +1,68 @@
+#pragma once
+
+#include "db/TransactionFilter.h"
+
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+// Streams filtered transactions from a ledger to CSV, JSON, HTML or PDF on a
+// background thread. Rows go straight from a forward-only query into the
+// output sink, so memory stays flat regardless of how many rows match.
+class ReportExporter : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(double progress READ progress NOTIFY progressChanged)
+    Q_PROPERTY(QString lastError READ lastError NOTIFY lastErrorChanged)
+
+public:
+    explicit ReportExporter(QObject *parent = nullptr);
+    ~ReportExporter() override;
+
+    void setDatabasePath(const QString &path);
+
+    bool running() const;
+    double progress() const;
+    QString lastError() const;
+
+    // `format` is a ReportSink::Format; `firstDay`/`lastDay` may be invalid
+    // to leave the range open. The remaining arguments follow
+    // TransactionsModel::setFilters.
+    Q_INVOKABLE bool exportReport(int format, const QString &fileUrl, const QDate &firstDay,
+                                  const QDate &lastDay, int typeFilter, const QString &categoryFilter,
+                                  const QString &textFilter);
+    Q_INVOKABLE void cancel();
+    Q_INVOKABLE void clearError();
+
+signals:
+    void runningChanged();
+    void progressChanged();
+    void lastErrorChanged();
+    void exportFinished(bool ok, const QString &filePath, int rowCount);
+
+private:
+    struct Job {
+        QString databasePath;
+        QString filePath;
+        QString title;
+        int format = 0;
+        TransactionFilter filter;
+        std::shared_ptr<std::atomic_bool> cancelled;
+    };
+
+    bool writeReport(const Job &job, int &rowCount, QString &errorMessage);
+    void setProgress(double progress);
+    void setLastError(const QString &message);
+    void finishJob(bool ok, bool cancelled, const QString &filePath, int rowCount,
+                   const QString &errorMessage);
+
+    QThreadPool m_pool;
+    QString m_databasePath;
+    std::shared_ptr<std::atomic_bool> m_cancelled;
+    bool m_running = false;
+    double m_progress = 0.0;
+    QString m_lastError;
+};
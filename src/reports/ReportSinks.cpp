@@ -0,0 +1,427 @@
+#include "ReportSinks.h"
+
+#include <QAbstractTextDocumentLayout>
+#include <QByteArray>
+#include <QFileDevice>
+#include <QIODevice>
+#include <QLocale>
+#include <QMarginsF>
+#include <QObject>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QStringList>
+#include <QTextDocument>
+
+namespace {
+constexpr qsizetype kChunkSize = 64 * 1024;
+constexpr int kPdfRowsPerPage = 40;
+constexpr int kPdfNoteLength = 48;
+constexpr int kPdfCategoryLength = 24;
+
+QString plainAmount(qint64 cents)
+{
+    const qint64 absolute = qAbs(cents);
+    return QString(cents < 0 ? "-" : "") + QString::number(absolute / 100) + '.'
+        + QString::number(absolute % 100).rightJustified(2, '0');
+}
+
+QString localeAmount(qint64 cents)
+{
+    const QLocale locale;
+    return locale.toString(static_cast<double>(cents) / 100.0, 'f', 2);
+}
+
+QString typeLabel(int type)
+{
+    return type == 1 ? QObject::tr("Income") : QObject::tr("Expense");
+}
+
+QString csvField(const QString &value)
+{
+    if (!value.contains(',') && !value.contains('"') && !value.contains('\n') && !value.contains('\r')) {
+        return value;
+    }
+    QString escaped = value;
+    escaped.replace('"', "\"\"");
+    return QChar('"') + escaped + QChar('"');
+}
+
+QString jsonString(const QString &value)
+{
+    QString out;
+    out.reserve(value.size() + 2);
+    out += '"';
+    for (const QChar c : value) {
+        switch (c.unicode()) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (c.unicode() < 0x20) {
+                out += QString("\\u%1").arg(static_cast<uint>(c.unicode()), 4, 16, QChar('0'));
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+    return out;
+}
+
+QString htmlRow(const ReportRow &row, const QString &note)
+{
+    return QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td class=\"amount\">%5</td></tr>\n")
+        .arg(row.date, typeLabel(row.type), row.category.toHtmlEscaped(), note.toHtmlEscaped(),
+             localeAmount(row.amountCents));
+}
+
+QString htmlRowsHeader()
+{
+    return QString("<tr><th>%1</th><th>%2</th><th>%3</th><th>%4</th><th class=\"amount\">%5</th></tr>\n")
+        .arg(QObject::tr("Date"), QObject::tr("Type"), QObject::tr("Category"), QObject::tr("Note"),
+             QObject::tr("Amount"));
+}
+
+QString htmlSubtotalRow(const CategorySubtotal &subtotal)
+{
+    return QString("<tr><td>%1</td><td class=\"amount\">%2</td><td class=\"amount\">%3</td></tr>\n")
+        .arg(subtotal.category.toHtmlEscaped(), localeAmount(subtotal.incomeCents),
+             localeAmount(subtotal.expensesCents));
+}
+
+QString htmlSubtotalsHeader()
+{
+    return QString("<tr><th>%1</th><th class=\"amount\">%2</th><th class=\"amount\">%3</th></tr>\n")
+        .arg(QObject::tr("Category"), QObject::tr("Income"), QObject::tr("Expenses"));
+}
+
+// Accumulates UTF-8 output and hands it to the device in kChunkSize pieces,
+// reusing the same allocation for every chunk.
+class ChunkedBuffer
+{
+public:
+    explicit ChunkedBuffer(QIODevice *device)
+        : m_device(device)
+    {
+        m_buffer.reserve(kChunkSize);
+    }
+
+    void append(const QString &text)
+    {
+        m_buffer.append(text.toUtf8());
+        if (m_buffer.size() >= kChunkSize) {
+            flush();
+        }
+    }
+
+    bool flush()
+    {
+        if (!m_buffer.isEmpty() && m_device->write(m_buffer) != m_buffer.size()) {
+            m_failed = true;
+        }
+        m_buffer.resize(0);
+        return !m_failed;
+    }
+
+    bool failed() const { return m_failed; }
+    QString errorString() const { return m_device->errorString(); }
+
+private:
+    QIODevice *m_device = nullptr;
+    QByteArray m_buffer;
+    bool m_failed = false;
+};
+
+class TextSink : public ReportSink
+{
+public:
+    explicit TextSink(QIODevice *device)
+        : m_out(device)
+    {
+    }
+
+    bool writeRow(const ReportRow &row, QString &errorMessage) override
+    {
+        writeRowText(row);
+        if (m_out.failed()) {
+            errorMessage = m_out.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    bool finish(const QList<CategorySubtotal> &subtotals, QString &errorMessage) override
+    {
+        writeFooter(subtotals);
+        if (!m_out.flush()) {
+            errorMessage = m_out.errorString();
+            return false;
+        }
+        return true;
+    }
+
+protected:
+    virtual void writeRowText(const ReportRow &row) = 0;
+    virtual void writeFooter(const QList<CategorySubtotal> &subtotals) = 0;
+
+    ChunkedBuffer m_out;
+};
+
+class CsvSink : public TextSink
+{
+public:
+    using TextSink::TextSink;
+
+    bool begin(QString &) override
+    {
+        m_out.append("id,date,type,category,note,amount\n");
+        return true;
+    }
+
+protected:
+    void writeRowText(const ReportRow &row) override
+    {
+        m_out.append(QString::number(row.id) + ',' + row.date + ',' + (row.type == 1 ? "income" : "expense")
+                     + ',' + csvField(row.category) + ',' + csvField(row.note) + ','
+                     + plainAmount(row.amountCents) + '\n');
+    }
+
+    // Subtotals follow the rows as a second table after a blank line.
+    void writeFooter(const QList<CategorySubtotal> &subtotals) override
+    {
+        m_out.append("\ncategory,income,expenses\n");
+        for (const CategorySubtotal &subtotal : subtotals) {
+            m_out.append(csvField(subtotal.category) + ',' + plainAmount(subtotal.incomeCents) + ','
+                         + plainAmount(subtotal.expensesCents) + '\n');
+        }
+    }
+};
+
+class JsonSink : public TextSink
+{
+public:
+    using TextSink::TextSink;
+
+    bool begin(QString &) override
+    {
+        m_out.append("{\"transactions\":[");
+        return true;
+    }
+
+protected:
+    void writeRowText(const ReportRow &row) override
+    {
+        m_out.append(QString(m_firstRow ? "\n" : ",\n") + "{\"id\":" + QString::number(row.id)
+                     + ",\"date\":" + jsonString(row.date)
+                     + ",\"type\":" + (row.type == 1 ? "\"income\"" : "\"expense\"")
+                     + ",\"category\":" + jsonString(row.category) + ",\"note\":" + jsonString(row.note)
+                     + ",\"amountCents\":" + QString::number(row.amountCents) + '}');
+        m_firstRow = false;
+    }
+
+    void writeFooter(const QList<CategorySubtotal> &subtotals) override
+    {
+        m_out.append("\n],\"subtotals\":[");
+        for (int i = 0; i < subtotals.size(); ++i) {
+            const CategorySubtotal &subtotal = subtotals.at(i);
+            m_out.append(QString(i == 0 ? "\n" : ",\n") + "{\"category\":" + jsonString(subtotal.category)
+                         + ",\"incomeCents\":" + QString::number(subtotal.incomeCents)
+                         + ",\"expensesCents\":" + QString::number(subtotal.expensesCents) + '}');
+        }
+        m_out.append("\n]}\n");
+    }
+
+private:
+    bool m_firstRow = true;
+};
+
+// Standalone HTML table that browsers render directly and QTextDocument can
+// load for printing.
+class HtmlSink : public TextSink
+{
+public:
+    HtmlSink(QIODevice *device, const QString &title)
+        : TextSink(device)
+        , m_title(title)
+    {
+    }
+
+    bool begin(QString &) override
+    {
+        m_out.append(QString("<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>%1</title>\n"
+                             "<style>table{border-collapse:collapse}th,td{padding:2px 8px;text-align:left}"
+                             ".amount{text-align:right}</style></head><body>\n<h1>%1</h1>\n<table>\n")
+                         .arg(m_title.toHtmlEscaped())
+                     + htmlRowsHeader());
+        return true;
+    }
+
+protected:
+    void writeRowText(const ReportRow &row) override
+    {
+        m_out.append(htmlRow(row, row.note));
+    }
+
+    void writeFooter(const QList<CategorySubtotal> &subtotals) override
+    {
+        m_out.append(QString("</table>\n<h2>%1</h2>\n<table>\n").arg(QObject::tr("Subtotals by category"))
+                     + htmlSubtotalsHeader());
+        for (const CategorySubtotal &subtotal : subtotals) {
+            m_out.append(htmlSubtotalRow(subtotal));
+        }
+        m_out.append("</table>\n</body></html>\n");
+    }
+
+private:
+    QString m_title;
+};
+
+// Lays out and paints one page of rows at a time through a throwaway
+// QTextDocument, so a long report never holds more than about a page of
+// markup.
+class PdfSink : public ReportSink
+{
+public:
+    PdfSink(QIODevice *device, const QString &title)
+        : m_device(device)
+        , m_writer(device)
+        , m_title(title)
+    {
+    }
+
+    bool begin(QString &errorMessage) override
+    {
+        m_writer.setTitle(m_title);
+        m_writer.setPageSize(QPageSize(QPageSize::A4));
+        m_writer.setPageMargins(QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter);
+        if (!m_painter.begin(&m_writer)) {
+            errorMessage = QObject::tr("Unable to start PDF output");
+            return false;
+        }
+        return true;
+    }
+
+    bool writeRow(const ReportRow &row, QString &errorMessage) override
+    {
+        // Both free-text columns are cut to one line so a row never wraps.
+        ReportRow shortened = row;
+        shortened.category = elide(row.category, kPdfCategoryLength);
+        m_pageRows.append(htmlRow(shortened, elide(row.note, kPdfNoteLength)));
+        if (m_pageRows.size() >= kPdfRowsPerPage) {
+            flushPage(htmlRowsHeader());
+        }
+
+        // QPdfWriter has no error state of its own; a failed write shows up
+        // on the file it writes to.
+        const auto *file = qobject_cast<const QFileDevice *>(m_device);
+        if (file && file->error() != QFileDevice::NoError) {
+            errorMessage = file->errorString();
+            return false;
+        }
+        return true;
+    }
+
+    bool finish(const QList<CategorySubtotal> &subtotals, QString &errorMessage) override
+    {
+        while (!m_pageRows.isEmpty() || !m_hasPage) {
+            flushPage(htmlRowsHeader());
+        }
+
+        const QString subtotalsTitle = QObject::tr("Subtotals by category");
+        for (const CategorySubtotal &subtotal : subtotals) {
+            CategorySubtotal shortened = subtotal;
+            shortened.category = elide(subtotal.category, kPdfCategoryLength);
+            m_pageRows.append(htmlSubtotalRow(shortened));
+            if (m_pageRows.size() >= kPdfRowsPerPage) {
+                flushPage(htmlSubtotalsHeader(), subtotalsTitle);
+            }
+        }
+        while (!m_pageRows.isEmpty()) {
+            flushPage(htmlSubtotalsHeader(), subtotalsTitle);
+        }
+
+        if (!m_painter.end()) {
+            errorMessage = QObject::tr("Unable to finish PDF output");
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static QString elide(const QString &text, int length)
+    {
+        return text.size() > length ? text.left(length - 1) + QChar(0x2026) : text;
+    }
+
+    // Paints as many pending rows as fit on one page. Rows that would run past
+    // the printable area stay pending for the next page instead of being
+    // clipped.
+    void flushPage(const QString &tableHeader, const QString &heading = QString())
+    {
+        QStringList carried;
+        while (true) {
+            QTextDocument document;
+            document.documentLayout()->setPaintDevice(&m_writer);
+            document.setTextWidth(m_writer.width());
+            document.setHtml(QString("<html><body style=\"font-size:9pt\"><h3>%1</h3>"
+                                     "<table width=\"100%\" cellpadding=\"2\">%2%3</table></body></html>")
+                                 .arg((heading.isEmpty() ? m_title : heading).toHtmlEscaped(), tableHeader,
+                                      m_pageRows.join(QString())));
+
+            const qreal pageHeight = m_writer.height();
+            const qreal contentHeight = document.size().height();
+            if (contentHeight <= pageHeight || m_pageRows.size() <= 1) {
+                if (m_hasPage) {
+                    m_writer.newPage();
+                }
+                document.drawContents(&m_painter);
+                break;
+            }
+
+            const int keep = qBound(1, static_cast<int>(m_pageRows.size() * pageHeight / contentHeight),
+                                    static_cast<int>(m_pageRows.size()) - 1);
+            carried = m_pageRows.mid(keep) + carried;
+            m_pageRows = m_pageRows.mid(0, keep);
+        }
+
+        m_hasPage = true;
+        m_pageRows = carried;
+    }
+
+    QIODevice *m_device = nullptr;
+    QPdfWriter m_writer;
+    QPainter m_painter;
+    QString m_title;
+    QStringList m_pageRows;
+    bool m_hasPage = false;
+};
+}
+
+std::unique_ptr<ReportSink> ReportSink::create(Format format, QIODevice *device, const QString &title)
+{
+    switch (format) {
+    case Csv:
+        return std::make_unique<CsvSink>(device);
+    case Json:
+        return std::make_unique<JsonSink>(device);
+    case Html:
+        return std::make_unique<HtmlSink>(device, title);
+    case Pdf:
+        return std::make_unique<PdfSink>(device, title);
+    }
+    return {};
+}
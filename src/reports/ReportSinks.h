@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include <memory>
+
+class QIODevice;
+
+struct ReportRow {
+    qint64 id = 0;
+    int type = 0;
+    qint64 amountCents = 0;
+    QString date;
+    QString category;
+    QString note;
+};
+
+struct CategorySubtotal {
+    QString category;
+    qint64 incomeCents = 0;
+    qint64 expensesCents = 0;
+};
+
+// Receives report rows one at a time and writes them to a device. Sinks hold
+// at most a fixed-size chunk (or one PDF page) of output in memory.
+class ReportSink
+{
+public:
+    enum Format {
+        Csv,
+        Json,
+        Html,
+        Pdf
+    };
+
+    virtual ~ReportSink() = default;
+
+    virtual bool begin(QString &errorMessage) = 0;
+    // Returns false once output can no longer be written; the caller should
+    // stop feeding rows and discard the file.
+    virtual bool writeRow(const ReportRow &row, QString &errorMessage) = 0;
+    virtual bool finish(const QList<CategorySubtotal> &subtotals, QString &errorMessage) = 0;
+
+    static std::unique_ptr<ReportSink> create(Format format, QIODevice *device, const QString &title);
+};
@@ -0,0 +1,70 @@
+#include "TransactionRowColors.h"
+
+TransactionRowColors::TransactionRowColors(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TransactionRowPalette TransactionRowColors::palette() const
+{
+    return m_palette;
+}
+
+QColor TransactionRowColors::incomeColor() const
+{
+    return m_palette.income;
+}
+
+void TransactionRowColors::setIncomeColor(const QColor &color)
+{
+    setColor(m_palette.income, color);
+}
+
+QColor TransactionRowColors::expenseColor() const
+{
+    return m_palette.expense;
+}
+
+void TransactionRowColors::setExpenseColor(const QColor &color)
+{
+    setColor(m_palette.expense, color);
+}
+
+QColor TransactionRowColors::textColor() const
+{
+    return m_palette.text;
+}
+
+void TransactionRowColors::setTextColor(const QColor &color)
+{
+    setColor(m_palette.text, color);
+}
+
+QColor TransactionRowColors::hintColor() const
+{
+    return m_palette.hint;
+}
+
+void TransactionRowColors::setHintColor(const QColor &color)
+{
+    setColor(m_palette.hint, color);
+}
+
+QColor TransactionRowColors::borderColor() const
+{
+    return m_palette.border;
+}
+
+void TransactionRowColors::setBorderColor(const QColor &color)
+{
+    setColor(m_palette.border, color);
+}
+
+void TransactionRowColors::setColor(QColor &target, const QColor &color)
+{
+    if (target == color) {
+        return;
+    }
+    target = color;
+    emit changed();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QColor>
+#include <QObject>
+#include <QtQml/qqmlregistration.h>
+
+// The colors a TransactionRow draws with. Default-constructed, it gives the
+// fallback colors without creating a TransactionRowColors.
+struct TransactionRowPalette {
+    QColor income = QColor(Qt::darkGreen);
+    QColor expense = QColor(Qt::darkRed);
+    QColor text = QColor(Qt::black);
+    QColor hint = QColor(Qt::gray);
+    QColor border = QColor(Qt::lightGray);
+};
+
+// Colors shared by every TransactionRow in a list. One instance binds to the
+// theme, so a theme change costs one set of bindings instead of five per
+// delegate.
+class TransactionRowColors : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(QColor incomeColor READ incomeColor WRITE setIncomeColor NOTIFY changed)
+    Q_PROPERTY(QColor expenseColor READ expenseColor WRITE setExpenseColor NOTIFY changed)
+    Q_PROPERTY(QColor textColor READ textColor WRITE setTextColor NOTIFY changed)
+    Q_PROPERTY(QColor hintColor READ hintColor WRITE setHintColor NOTIFY changed)
+    Q_PROPERTY(QColor borderColor READ borderColor WRITE setBorderColor NOTIFY changed)
+
+public:
+    explicit TransactionRowColors(QObject *parent = nullptr);
+
+    TransactionRowPalette palette() const;
+
+    QColor incomeColor() const;
+    void setIncomeColor(const QColor &color);
+    QColor expenseColor() const;
+    void setExpenseColor(const QColor &color);
+    QColor textColor() const;
+    void setTextColor(const QColor &color);
+    QColor hintColor() const;
+    void setHintColor(const QColor &color);
+    QColor borderColor() const;
+    void setBorderColor(const QColor &color);
+
+signals:
+    void changed();
+
+private:
+    void setColor(QColor &target, const QColor &color);
+
+    TransactionRowPalette m_palette;
+};
@@ -0,0 +1,258 @@
+#include "TransactionRowItem.h"
+
+#include <QFontMetricsF>
+#include <QGuiApplication>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QQuickWindow>
+#include <QSGNode>
+#include <QSGRectangleNode>
+#include <QSGTextNode>
+
+namespace {
+constexpr qreal kPadding = 12.0;
+constexpr qreal kSpacing = 12.0;
+constexpr qreal kIndicatorWidth = 8.0;
+constexpr qreal kIndicatorHeight = 48.0;
+constexpr qreal kLineSpacing = 4.0;
+constexpr qreal kDeletePadding = 8.0;
+constexpr qreal kBorderWidth = 1.0;
+constexpr qreal kFocusBorderWidth = 2.0;
+
+// Keeps typed pointers to the children so updates never walk the node tree.
+class RowNode : public QSGNode
+{
+public:
+    std::array<QSGRectangleNode *, 4> edges = {};
+    QSGRectangleNode *indicator = nullptr;
+    QSGTextNode *text = nullptr;
+    QSGTextNode *hintText = nullptr;
+};
+
+void shapeLine(QTextLayout &layout, const QString &text, const QFont &font)
+{
+    layout.clearLayout();
+    layout.setText(text);
+    layout.setFont(font);
+    layout.setCacheEnabled(true);
+    layout.beginLayout();
+    QTextLine line = layout.createLine();
+    if (line.isValid()) {
+        line.setNumColumns(text.size());
+        line.setPosition(QPointF(0, 0));
+    }
+    layout.endLayout();
+}
+}
+
+TransactionRowItem::TransactionRowItem(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_titleFont(QGuiApplication::font())
+    , m_detailFont(QGuiApplication::font())
+    , m_deleteText(tr("Delete"))
+{
+    m_titleFont.setPixelSize(16);
+    m_titleFont.setWeight(QFont::DemiBold);
+    m_detailFont.setPixelSize(12);
+
+    setFlag(ItemHasContents);
+    setActiveFocusOnTab(true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setImplicitHeight(kIndicatorHeight + 2 * kPadding);
+    syncColors();
+}
+
+QVariant TransactionRowItem::row() const
+{
+    return QVariant::fromValue(m_row);
+}
+
+void TransactionRowItem::setRow(const QVariant &row)
+{
+    m_row = row.value<TransactionsModel::Transaction>();
+    emit rowChanged();
+    polish();
+}
+
+TransactionRowColors *TransactionRowItem::colors() const
+{
+    return m_colors;
+}
+
+void TransactionRowItem::setColors(TransactionRowColors *colors)
+{
+    if (m_colors == colors) {
+        return;
+    }
+    if (m_colors) {
+        disconnect(m_colors, nullptr, this, nullptr);
+    }
+    m_colors = colors;
+    if (m_colors) {
+        connect(m_colors, &TransactionRowColors::changed, this, &TransactionRowItem::syncColors);
+    }
+    syncColors();
+    emit colorsChanged();
+}
+
+QString TransactionRowItem::accessibleName() const
+{
+    return tr("%1, %2, %3, %4")
+        .arg(m_row.type == 1 ? tr("Income") : tr("Expense"), m_row.category, m_row.amountFormatted,
+             m_row.dateFormatted);
+}
+
+void TransactionRowItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        polish();
+    }
+}
+
+void TransactionRowItem::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+    if (change == ItemActiveFocusHasChanged) {
+        update();
+    }
+}
+
+// Elides and shapes the labels on the GUI thread; updatePaintNode() only
+// hands the finished layouts to the text nodes.
+void TransactionRowItem::updatePolish()
+{
+    const QFontMetricsF titleMetrics(m_titleFont);
+    const QFontMetricsF detailMetrics(m_detailFont);
+    const QRectF deleteArea = deleteRect();
+    const qreal left = kPadding + kIndicatorWidth + kSpacing;
+    const qreal right = deleteArea.left() - kSpacing;
+    const qreal width = qMax<qreal>(0, right - left);
+    const qreal top = (height() - titleMetrics.height() - kLineSpacing - detailMetrics.height()) / 2;
+    const qreal detailTop = top + titleMetrics.height() + kLineSpacing;
+
+    const qreal amountWidth = titleMetrics.horizontalAdvance(m_row.amountFormatted);
+    const qreal dateWidth = detailMetrics.horizontalAdvance(m_row.dateFormatted);
+    const qreal deleteWidth = detailMetrics.horizontalAdvance(m_deleteText);
+
+    shapeLine(m_layouts[CategoryText],
+              titleMetrics.elidedText(m_row.category, Qt::ElideRight, qMax<qreal>(0, width - amountWidth - 6)),
+              m_titleFont);
+    m_positions[CategoryText] = QPointF(left, top);
+
+    shapeLine(m_layouts[AmountText], m_row.amountFormatted, m_titleFont);
+    m_positions[AmountText] = QPointF(right - amountWidth, top);
+
+    shapeLine(m_layouts[DeleteText], m_deleteText, m_detailFont);
+    m_positions[DeleteText] = QPointF(deleteArea.center().x() - deleteWidth / 2,
+                                      (height() - detailMetrics.height()) / 2);
+
+    shapeLine(m_layouts[DateText], m_row.dateFormatted, m_detailFont);
+    m_positions[DateText] = QPointF(left, detailTop);
+
+    shapeLine(m_layouts[NoteText],
+              detailMetrics.elidedText(m_row.note, Qt::ElideRight, qMax<qreal>(0, width - dateWidth - 8)),
+              m_detailFont);
+    m_positions[NoteText] = QPointF(left + dateWidth + 8, detailTop);
+
+    update();
+}
+
+QSGNode *TransactionRowItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data)
+
+    auto *node = static_cast<RowNode *>(oldNode);
+    if (!node) {
+        node = new RowNode;
+        for (QSGRectangleNode *&edge : node->edges) {
+            edge = window()->createRectangleNode();
+            node->appendChildNode(edge);
+        }
+        node->indicator = window()->createRectangleNode();
+        node->appendChildNode(node->indicator);
+        node->text = window()->createTextNode();
+        node->appendChildNode(node->text);
+        node->hintText = window()->createTextNode();
+        node->appendChildNode(node->hintText);
+    }
+
+    const qreal w = width();
+    const qreal h = height();
+    const qreal border = hasActiveFocus() ? kFocusBorderWidth : kBorderWidth;
+    node->edges[0]->setRect(QRectF(0, 0, w, border));
+    node->edges[1]->setRect(QRectF(0, h - border, w, border));
+    node->edges[2]->setRect(QRectF(0, 0, border, h));
+    node->edges[3]->setRect(QRectF(w - border, 0, border, h));
+    for (QSGRectangleNode *edge : node->edges) {
+        edge->setColor(hasActiveFocus() ? m_palette.text : m_palette.border);
+    }
+
+    const qreal indicatorHeight = qMax<qreal>(0, qMin(kIndicatorHeight, h - 2 * kPadding));
+    node->indicator->setRect(QRectF(kPadding, (h - indicatorHeight) / 2, kIndicatorWidth, indicatorHeight));
+    node->indicator->setColor(m_row.type == 1 ? m_palette.income : m_palette.expense);
+
+    // The color is applied to glyphs as they are added, so set it first.
+    node->text->clear();
+    node->text->setColor(m_palette.text);
+    for (const TextRun run : {CategoryText, AmountText, DeleteText}) {
+        node->text->addTextLayout(m_positions[run], &m_layouts[run]);
+    }
+
+    node->hintText->clear();
+    node->hintText->setColor(m_palette.hint);
+    for (const TextRun run : {DateText, NoteText}) {
+        node->hintText->addTextLayout(m_positions[run], &m_layouts[run]);
+    }
+
+    return node;
+}
+
+void TransactionRowItem::mousePressEvent(QMouseEvent *event)
+{
+    event->accept();
+}
+
+void TransactionRowItem::mouseReleaseEvent(QMouseEvent *event)
+{
+    const QPointF position = event->position();
+    if (!contains(position)) {
+        return;
+    }
+    if (deleteRect().contains(position)) {
+        emit deleteRequested();
+    } else {
+        emit editRequested();
+    }
+}
+
+void TransactionRowItem::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+    case Qt::Key_Space:
+        emit editRequested();
+        break;
+    case Qt::Key_Delete:
+        emit deleteRequested();
+        break;
+    default:
+        QQuickItem::keyPressEvent(event);
+        return;
+    }
+    event->accept();
+}
+
+void TransactionRowItem::syncColors()
+{
+    m_palette = m_colors ? m_colors->palette() : TransactionRowPalette();
+    update();
+}
+
+QRectF TransactionRowItem::deleteRect() const
+{
+    const qreal textWidth = QFontMetricsF(m_detailFont).horizontalAdvance(m_deleteText);
+    const qreal width = textWidth + 2 * kDeletePadding;
+    return QRectF(this->width() - kPadding - width, 0, width, height());
+}
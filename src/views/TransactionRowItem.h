@@ -0,0 +1,78 @@
+#pragma once
+
+#include "models/TransactionsModel.h"
+#include "views/TransactionRowColors.h"
+
+#include <QFont>
+#include <QPointer>
+#include <QQuickItem>
+#include <QTextLayout>
+#include <QtQml/qqmlregistration.h>
+
+#include <array>
+
+// Draws a transaction row from TransactionsModel's "row" role with scene
+// graph nodes: rectangles for the frame and type indicator and text nodes for
+// the labels. Text is shaped in updatePolish() and only re-shaped when the row
+// or width changes, so a recycled delegate costs one item and one model
+// binding. Clicking the trailing "Delete" text or pressing Delete emits
+// deleteRequested(); clicking anywhere else or pressing Enter emits
+// editRequested(). Rows take focus on Tab and draw a heavier frame while
+// focused.
+class TransactionRowItem : public QQuickItem
+{
+    Q_OBJECT
+    QML_NAMED_ELEMENT(TransactionRow)
+    Q_PROPERTY(QVariant row READ row WRITE setRow NOTIFY rowChanged)
+    Q_PROPERTY(TransactionRowColors *colors READ colors WRITE setColors NOTIFY colorsChanged)
+    Q_PROPERTY(QString accessibleName READ accessibleName NOTIFY rowChanged)
+
+public:
+    explicit TransactionRowItem(QQuickItem *parent = nullptr);
+
+    QVariant row() const;
+    void setRow(const QVariant &row);
+
+    TransactionRowColors *colors() const;
+    void setColors(TransactionRowColors *colors);
+
+    // Spoken summary of the row, for binding to Accessible.name.
+    QString accessibleName() const;
+
+signals:
+    void rowChanged();
+    void colorsChanged();
+    void editRequested();
+    void deleteRequested();
+
+protected:
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &value) override;
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    enum TextRun {
+        CategoryText,
+        AmountText,
+        DeleteText,
+        DateText,
+        NoteText,
+        TextRunCount
+    };
+
+    void syncColors();
+    QRectF deleteRect() const;
+
+    TransactionsModel::Transaction m_row;
+    QPointer<TransactionRowColors> m_colors;
+    TransactionRowPalette m_palette;
+    QFont m_titleFont;
+    QFont m_detailFont;
+    QString m_deleteText;
+    std::array<QTextLayout, TextRunCount> m_layouts;
+    std::array<QPointF, TextRunCount> m_positions;
+};